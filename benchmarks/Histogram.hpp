@@ -0,0 +1,152 @@
+/*
+ * (C) 2024 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#ifndef __ALPHA_BENCHMARK_HISTOGRAM_HPP
+#define __ALPHA_BENCHMARK_HISTOGRAM_HPP
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace alpha {
+
+/**
+ * @brief Histogram with HDR-style log-linear buckets: values below
+ * 2^significant_bits are recorded exactly, larger values are recorded
+ * with significant_bits bits of precision (a relative error below
+ * 2^-(significant_bits-1)), up to 2^max_bits. Larger values are recorded
+ * in the last bucket.
+ *
+ * record() is thread-safe and lock-free (relaxed atomic increments),
+ * so many ULTs can record into the same Histogram.
+ */
+class Histogram {
+
+    using json = nlohmann::json;
+
+    public:
+
+    explicit Histogram(unsigned significant_bits = 7, unsigned max_bits = 40)
+    : m_bits(significant_bits)
+    , m_half(uint64_t{1} << (significant_bits - 1))
+    , m_max_value((uint64_t{1} << max_bits) - 1)
+    , m_counts(indexOf(m_max_value) + 1) {}
+
+    Histogram(Histogram&&) = default;
+
+    Histogram& operator=(Histogram&&) = default;
+
+    /**
+     * @brief Record a value.
+     */
+    void record(uint64_t value) {
+        m_counts[indexOf(std::min(value, m_max_value))].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Add the counts of another Histogram with the same parameters.
+     */
+    void merge(const Histogram& other) {
+        for(size_t i = 0; i < m_counts.size(); ++i)
+            m_counts[i].fetch_add(other.m_counts[i].load(std::memory_order_relaxed),
+                                  std::memory_order_relaxed);
+    }
+
+    uint64_t count() const {
+        uint64_t total = 0;
+        for(auto& c : m_counts) total += c.load(std::memory_order_relaxed);
+        return total;
+    }
+
+    /**
+     * @brief Return the highest value equivalent to the value at the
+     * given percentile (between 0 and 100), or 0 if the histogram is empty.
+     */
+    uint64_t percentile(double p) const {
+        auto total = count();
+        if(total == 0) return 0;
+        auto rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(p/100.0 * total)));
+        uint64_t seen = 0;
+        for(size_t i = 0; i < m_counts.size(); ++i) {
+            seen += m_counts[i].load(std::memory_order_relaxed);
+            if(seen >= rank) return highestEquivalentValue(i);
+        }
+        return m_max_value;
+    }
+
+    uint64_t max() const {
+        for(size_t i = m_counts.size(); i > 0; --i)
+            if(m_counts[i-1].load(std::memory_order_relaxed)) return highestEquivalentValue(i-1);
+        return 0;
+    }
+
+    /**
+     * @brief Summary with the usual percentiles.
+     */
+    json summary() const {
+        return json{
+            {"count", count()},
+            {"p50", percentile(50)},
+            {"p90", percentile(90)},
+            {"p99", percentile(99)},
+            {"p99.9", percentile(99.9)},
+            {"max", max()}
+        };
+    }
+
+    /**
+     * @brief Serialize the non-empty buckets as [index, count] pairs.
+     */
+    json toJson() const {
+        auto buckets = json::array();
+        for(size_t i = 0; i < m_counts.size(); ++i) {
+            auto c = m_counts[i].load(std::memory_order_relaxed);
+            if(c) buckets.push_back({i, c});
+        }
+        return buckets;
+    }
+
+    /**
+     * @brief Add the counts serialized by toJson() (by a Histogram
+     * with the same parameters).
+     */
+    void mergeJson(const json& buckets) {
+        for(auto& b : buckets) {
+            auto i = b[0].get<size_t>();
+            if(i < m_counts.size())
+                m_counts[i].fetch_add(b[1].get<uint64_t>(), std::memory_order_relaxed);
+        }
+    }
+
+    private:
+
+    size_t indexOf(uint64_t value) const {
+        auto width = static_cast<unsigned>(std::bit_width(value));
+        if(width <= m_bits) return value;
+        auto shift = width - m_bits;
+        return shift*m_half + (value >> shift);
+    }
+
+    uint64_t highestEquivalentValue(size_t index) const {
+        if(index < 2*m_half) return index;
+        auto shift = index/m_half - 1;
+        auto sub   = index - shift*m_half;
+        return ((sub + 1) << shift) - 1;
+    }
+
+    unsigned                           m_bits;
+    uint64_t                           m_half;
+    uint64_t                           m_max_value;
+    std::vector<std::atomic<uint64_t>> m_counts;
+};
+
+}
+
+#endif
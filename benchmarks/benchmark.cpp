@@ -0,0 +1,309 @@
+/*
+ * (C) 2024 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#include <alpha/Client.hpp>
+#include <alpha/Provider.hpp>
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+#include <spdlog/sinks/stdout_color_sinks.h>
+#include <tclap/CmdLine.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <vector>
+
+namespace tl = thallium;
+using json = nlohmann::json;
+using clock_type = std::chrono::steady_clock;
+
+static std::string g_address;
+static std::string g_protocol = "na+sm";
+static unsigned    g_provider_id;
+static unsigned    g_num_providers;
+static std::string g_provider_config;
+static std::string g_client_config;
+static unsigned    g_num_xstreams;
+static unsigned    g_max_ults;
+static size_t      g_scalar_iterations;
+static size_t      g_max_size;
+static size_t      g_size_factor;
+static size_t      g_concurrency_size;
+static double      g_min_time;
+static std::string g_output;
+static std::string g_log_level = "info";
+
+static void parse_command_line(int argc, char** argv);
+
+// TUTORIAL
+// ********
+//
+// alpha-benchmark measures the performance of alpha providers. If no address
+// is given, it starts num-providers providers in its own process (over na+sm
+// by default), otherwise it connects to num-providers providers at the given
+// address, with consecutive ids starting at the given provider id. It then
+// runs the following benchmarks and outputs their results in JSON:
+//
+// - "scalar_latency": latency percentiles of sequential computeSum calls;
+// - "throughput": latency and bandwidth of sequential computeSums calls with
+//   arrays from 1 element to max-size bytes (per array);
+// - "ult_scaling": throughput of computeSum and computeSums calls issued by
+//   1 to max-ults concurrent ULTs, spread over all the providers;
+// - "provider_scaling": same with max-ults ULTs, spread over 1 to
+//   num-providers providers.
+//
+// Client ULTs run in a pool served by num-xstreams execution streams.
+
+/**
+ * @brief Summarize a set of latencies (in nanoseconds).
+ */
+static json summarize(std::vector<uint64_t>& latencies) {
+    if(latencies.empty()) return json::object();
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&](double p) {
+        auto index = static_cast<size_t>(std::ceil(p/100.0 * latencies.size())) - 1;
+        return latencies[std::min(index, latencies.size() - 1)];
+    };
+    auto sum = std::accumulate(latencies.begin(), latencies.end(), 0.0);
+    return json{
+        {"count", latencies.size()},
+        {"min", latencies.front()},
+        {"mean", sum / latencies.size()},
+        {"p50", percentile(50)},
+        {"p90", percentile(90)},
+        {"p99", percentile(99)},
+        {"p99.9", percentile(99.9)},
+        {"max", latencies.back()}
+    };
+}
+
+static uint64_t elapsedNs(clock_type::time_point start) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(clock_type::now() - start).count();
+}
+
+static json scalarLatency(const alpha::ResourceHandle& handle) {
+    spdlog::info("Measuring computeSum latency ({} iterations)", g_scalar_iterations);
+    for(size_t i = 0; i < std::min<size_t>(100, g_scalar_iterations); ++i)
+        handle.computeSum(1, 2).wait();
+    std::vector<uint64_t> latencies;
+    latencies.reserve(g_scalar_iterations);
+    for(size_t i = 0; i < g_scalar_iterations; ++i) {
+        auto start = clock_type::now();
+        handle.computeSum(static_cast<int32_t>(i), 1).wait();
+        latencies.push_back(elapsedNs(start));
+    }
+    return json{{"latency_ns", summarize(latencies)}};
+}
+
+static json throughput(const alpha::ResourceHandle& handle) {
+    const size_t max_elements = std::max<size_t>(1, g_max_size / sizeof(int32_t));
+    spdlog::info("Allocating {} bytes for throughput benchmarks", 3*max_elements*sizeof(int32_t));
+    std::vector<int32_t> x(max_elements, 1), y(max_elements, 2), r(max_elements, 0);
+    // 1, f, f^2, ... elements, up to max_elements
+    std::vector<size_t> counts;
+    for(size_t n = 1; n < max_elements; n *= g_size_factor) counts.push_back(n);
+    counts.push_back(max_elements);
+    auto results = json::array();
+    for(auto n : counts) {
+        auto size = n*sizeof(int32_t);
+        spdlog::info("Measuring computeSums throughput for {} bytes", size);
+        auto xs = std::span<const int32_t>{x.data(), n};
+        auto ys = std::span<const int32_t>{y.data(), n};
+        auto rs = std::span<int32_t>{r.data(), n};
+        handle.computeSums(xs, ys, rs).wait();
+        std::vector<uint64_t> latencies;
+        auto start = clock_type::now();
+        while(latencies.size() < 3 || elapsedNs(start) < g_min_time*1e9) {
+            auto t = clock_type::now();
+            handle.computeSums(xs, ys, rs).wait();
+            latencies.push_back(elapsedNs(t));
+        }
+        double seconds = std::accumulate(latencies.begin(), latencies.end(), 0.0) / 1e9;
+        double reps = static_cast<double>(latencies.size());
+        results.push_back({
+            {"elements", n},
+            {"size_bytes", size},
+            {"elements_per_sec", reps*n / seconds},
+            // x and y are pulled, and the result pushed
+            {"bytes_moved_per_sec", reps*3*size / seconds},
+            {"latency_ns", summarize(latencies)}
+        });
+    }
+    return results;
+}
+
+/**
+ * @brief Run num_ults ULTs issuing computeSum (if elements is 0) or
+ * computeSums calls for min-time seconds, against the first num_providers
+ * handles, and return the resulting throughput and latencies.
+ */
+static json concurrent(const std::vector<alpha::ResourceHandle>& handles,
+                       tl::pool& pool, unsigned num_ults, unsigned num_providers,
+                       size_t elements) {
+    spdlog::info("Measuring {} with {} ULTs and {} providers",
+                 elements ? "computeSums" : "computeSum", num_ults, num_providers);
+    std::vector<std::vector<uint64_t>> latencies(num_ults);
+    std::vector<tl::managed<tl::thread>> ults;
+    auto deadline = clock_type::now() + std::chrono::duration<double>(g_min_time);
+    for(unsigned u = 0; u < num_ults; ++u) {
+        ults.push_back(pool.make_thread([&, u]() {
+            auto& handle = handles[u % num_providers];
+            std::vector<int32_t> x(elements, 1), y(elements, 2), r(elements);
+            while(clock_type::now() < deadline) {
+                auto start = clock_type::now();
+                if(elements == 0)
+                    handle.computeSum(static_cast<int32_t>(u), 1).wait();
+                else
+                    handle.computeSums(x, y, r).wait();
+                latencies[u].push_back(elapsedNs(start));
+            }
+        }));
+    }
+    for(auto& ult : ults) ult->join();
+    std::vector<uint64_t> all;
+    for(auto& l : latencies) all.insert(all.end(), l.begin(), l.end());
+    auto ops = all.size();
+    return json{
+        {"ults", num_ults},
+        {"providers", num_providers},
+        {"elements", elements},
+        {"operations", ops},
+        {"operations_per_sec", ops / g_min_time},
+        {"latency_ns", summarize(all)}
+    };
+}
+
+int main(int argc, char** argv) {
+    parse_command_line(argc, argv);
+    spdlog::set_default_logger(spdlog::stderr_color_mt("alpha-benchmark"));
+    spdlog::set_level(spdlog::level::from_str(g_log_level));
+
+    // the progress loop runs in its own execution stream so that the
+    // client ULTs do not compete with it
+    tl::engine engine(g_protocol, g_address.empty() ? THALLIUM_SERVER_MODE : THALLIUM_CLIENT_MODE,
+                      true, g_address.empty() ? static_cast<int>(g_num_xstreams) : 0);
+
+    json results;
+    try {
+
+        std::vector<alpha::Provider> providers;
+        std::string address = g_address;
+        if(g_address.empty()) {
+            for(unsigned i = 0; i < g_num_providers; ++i)
+                providers.emplace_back(engine, g_provider_id + i, g_provider_config);
+            address = static_cast<std::string>(engine.self());
+        }
+
+        alpha::Client client(engine, g_client_config);
+        std::vector<alpha::ResourceHandle> handles;
+        for(unsigned i = 0; i < g_num_providers; ++i)
+            handles.push_back(client.makeResourceHandle(address, g_provider_id + i, true));
+
+        auto pool = tl::pool::create(tl::pool::access::mpmc);
+        std::vector<tl::managed<tl::xstream>> xstreams;
+        for(unsigned i = 0; i < g_num_xstreams; ++i)
+            xstreams.push_back(tl::xstream::create(tl::scheduler::predef::basic_wait, *pool));
+
+        results["config"] = {
+            {"address", address},
+            {"in_process", g_address.empty()},
+            {"num_providers", g_num_providers},
+            {"num_xstreams", g_num_xstreams},
+            {"min_time", g_min_time},
+            {"client", json::parse(client.getConfig())}
+        };
+        if(!providers.empty())
+            results["config"]["provider"] = json::parse(providers[0].getConfig());
+
+        results["scalar_latency"] = scalarLatency(handles[0]);
+        results["throughput"] = throughput(handles[0]);
+
+        const size_t concurrency_elements = std::max<size_t>(1, g_concurrency_size / sizeof(int32_t));
+        results["ult_scaling"] = json::array();
+        for(unsigned u = 1; u <= g_max_ults; u *= 2) {
+            results["ult_scaling"].push_back(concurrent(handles, *pool, u, g_num_providers, 0));
+            results["ult_scaling"].push_back(concurrent(handles, *pool, u, g_num_providers, concurrency_elements));
+        }
+        results["provider_scaling"] = json::array();
+        for(unsigned p = 1; p <= g_num_providers; p *= 2) {
+            results["provider_scaling"].push_back(concurrent(handles, *pool, g_max_ults, p, 0));
+            results["provider_scaling"].push_back(concurrent(handles, *pool, g_max_ults, p, concurrency_elements));
+        }
+
+        for(auto& xstream : xstreams) xstream->join();
+        if(!providers.empty())
+            results["provider_stats"] = json::parse(providers[0].getStats());
+
+    } catch(const alpha::Exception& ex) {
+        std::cerr << ex.what() << std::endl;
+        exit(-1);
+    }
+
+    if(g_output == "-") {
+        std::cout << results.dump(4) << std::endl;
+    } else {
+        std::ofstream out(g_output);
+        out << results.dump(4) << std::endl;
+    }
+    return 0;
+}
+
+void parse_command_line(int argc, char** argv) {
+    try {
+        TCLAP::CmdLine cmd("Alpha benchmark", ' ', "0.1");
+        TCLAP::ValueArg<std::string> addressArg("a","address","Address of the server (default: start providers in-process)", false,"","string");
+        TCLAP::ValueArg<std::string> protocolArg("P","protocol","Protocol to use for in-process providers (default na+sm)", false,"na+sm","string");
+        TCLAP::ValueArg<unsigned>    providerArg("p", "provider", "First provider id (default 0)", false, 0, "int");
+        TCLAP::ValueArg<unsigned>    providersArg("n", "num-providers", "Number of providers (default 1)", false, 1, "int");
+        TCLAP::ValueArg<std::string> providerConfigArg("c", "provider-config", "JSON configuration of in-process providers", false,
+                                                       R"({"resource":{"type":"dummy"}})", "json");
+        TCLAP::ValueArg<std::string> clientConfigArg("C", "client-config", "JSON configuration of the client", false, "{}", "json");
+        TCLAP::ValueArg<unsigned>    xstreamsArg("x", "num-xstreams", "Number of execution streams for client ULTs (default 4)", false, 4, "int");
+        TCLAP::ValueArg<unsigned>    ultsArg("u", "max-ults", "Maximum number of concurrent client ULTs (default 64)", false, 64, "int");
+        TCLAP::ValueArg<size_t>      iterationsArg("i", "iterations", "Number of computeSum calls for latency (default 10000)", false, 10000, "int");
+        TCLAP::ValueArg<size_t>      maxSizeArg("s", "max-size", "Maximum array size in bytes (default 1 GiB)", false, size_t{1} << 30, "int");
+        TCLAP::ValueArg<size_t>      factorArg("f", "size-factor", "Factor between consecutive array sizes (default 4)", false, 4, "int");
+        TCLAP::ValueArg<size_t>      concurrencySizeArg("S", "concurrency-size", "Array size in bytes for concurrent computeSums (default 64 KiB)", false, 64*1024, "int");
+        TCLAP::ValueArg<double>      minTimeArg("t", "min-time", "Minimum duration of each measurement in seconds (default 1)", false, 1.0, "float");
+        TCLAP::ValueArg<std::string> outputArg("o", "output", "Output file, - for stdout (default -)", false, "-", "string");
+        TCLAP::ValueArg<std::string> logLevel("v","verbose", "Log level (trace, debug, info, warning, error, critical, off)", false, "info", "string");
+        cmd.add(addressArg);
+        cmd.add(protocolArg);
+        cmd.add(providerArg);
+        cmd.add(providersArg);
+        cmd.add(providerConfigArg);
+        cmd.add(clientConfigArg);
+        cmd.add(xstreamsArg);
+        cmd.add(ultsArg);
+        cmd.add(iterationsArg);
+        cmd.add(maxSizeArg);
+        cmd.add(factorArg);
+        cmd.add(concurrencySizeArg);
+        cmd.add(minTimeArg);
+        cmd.add(outputArg);
+        cmd.add(logLevel);
+        cmd.parse(argc, argv);
+        g_address = addressArg.getValue();
+        g_provider_id = providerArg.getValue();
+        g_num_providers = std::max(providersArg.getValue(), 1u);
+        g_provider_config = providerConfigArg.getValue();
+        g_client_config = clientConfigArg.getValue();
+        g_num_xstreams = std::max(xstreamsArg.getValue(), 1u);
+        g_max_ults = std::max(ultsArg.getValue(), 1u);
+        g_scalar_iterations = iterationsArg.getValue();
+        g_max_size = maxSizeArg.getValue();
+        g_size_factor = std::max<size_t>(factorArg.getValue(), 2);
+        g_concurrency_size = concurrencySizeArg.getValue();
+        g_min_time = minTimeArg.getValue();
+        g_output = outputArg.getValue();
+        g_log_level = logLevel.getValue();
+        g_protocol = g_address.empty() ? protocolArg.getValue() : g_address.substr(0, g_address.find(":"));
+    } catch(TCLAP::ArgException &e) {
+        std::cerr << "error: " << e.error() << " for arg " << e.argId() << std::endl;
+        exit(-1);
+    }
+}
@@ -0,0 +1,449 @@
+/*
+ * (C) 2024 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#include "Histogram.hpp"
+
+#include <alpha/Client.hpp>
+#include <alpha/Provider.hpp>
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+#include <spdlog/sinks/stdout_color_sinks.h>
+#include <tclap/CmdLine.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace tl = thallium;
+using json = nlohmann::json;
+using clock_type = std::chrono::steady_clock;
+
+static std::string g_address;
+static std::string g_protocol = "na+sm";
+static unsigned    g_provider_id;
+static std::string g_provider_config;
+static std::string g_client_config;
+static double      g_rate;
+static double      g_duration;
+static std::string g_arrival;
+static std::string g_mix;
+static unsigned    g_num_processes;
+static unsigned    g_num_xstreams;
+static size_t      g_max_outstanding;
+static unsigned    g_seed;
+static std::string g_output;
+static std::string g_log_level = "info";
+
+static void parse_command_line(int argc, char** argv);
+
+// TUTORIAL
+// ********
+//
+// alpha-load-generator is an open-loop load generator: requests are issued
+// at times drawn from an arrival process (constant interval or Poisson) with
+// a given target rate, regardless of whether previous requests completed.
+// This exposes queueing at the provider that closed-loop clients (which wait
+// for a response before sending the next request) hide.
+//
+// Latency is measured from the time at which a request was supposed to be
+// sent, not from the time it was actually sent, which corrects for
+// coordinated omission: if the generator itself falls behind, the delay
+// shows up in the latencies instead of silently lowering the rate.
+//
+// When max-outstanding requests are already in flight, new requests are
+// skipped rather than sent. Skipped requests never complete, so leaving them
+// out would hide the slowest requests, which is another form of coordinated
+// omission. Each of them is therefore recorded, once the outstanding requests
+// have completed, with the time elapsed since its intended send time as its
+// latency. This is only a lower bound, so the percentiles of a second with
+// skipped requests are reported as lower bounds ("lower_bound": true).
+//
+// The load is split across num-processes client processes (created with
+// fork), each issuing requests at rate/num-processes. Each request is a
+// computeSum (size 0) or a computeSums on arrays of the given number of
+// elements, drawn from the size mix. Latencies are recorded in a Histogram
+// per second of the run, and the histograms of all the processes are merged
+// to report p50/p99/p99.9 for each second.
+//
+// If no address is given, a provider is started by the parent process.
+
+struct MixEntry {
+    size_t elements;
+    double weight;
+};
+
+/**
+ * @brief Parse a size mix of the form "0:0.9,1024:0.1" (elements:weight).
+ */
+static std::vector<MixEntry> parseMix(const std::string& mix) {
+    std::vector<MixEntry> entries;
+    std::stringstream ss(mix);
+    std::string item;
+    while(std::getline(ss, item, ',')) {
+        auto colon = item.find(':');
+        MixEntry entry;
+        entry.elements = std::stoull(item.substr(0, colon));
+        entry.weight   = colon == std::string::npos ? 1.0 : std::stod(item.substr(colon + 1));
+        entries.push_back(entry);
+    }
+    if(entries.empty()) throw std::invalid_argument{"empty size mix"};
+    return entries;
+}
+
+/**
+ * @brief Pool of result buffers for a given array size, so that
+ * concurrent computeSums requests do not write into the same memory.
+ */
+class ResultBuffers {
+
+    size_t                            m_elements;
+    tl::mutex                         m_mutex;
+    std::vector<std::vector<int32_t>> m_free;
+
+    public:
+
+    explicit ResultBuffers(size_t elements)
+    : m_elements(elements) {}
+
+    std::vector<int32_t> acquire() {
+        std::unique_lock<tl::mutex> lock{m_mutex};
+        if(m_free.empty()) return std::vector<int32_t>(m_elements);
+        auto buffer = std::move(m_free.back());
+        m_free.pop_back();
+        return buffer;
+    }
+
+    void release(std::vector<int32_t>&& buffer) {
+        std::unique_lock<tl::mutex> lock{m_mutex};
+        m_free.push_back(std::move(buffer));
+    }
+};
+
+/**
+ * @brief Body of a client process: generate the load against the
+ * provider at the given address and return the results as JSON.
+ */
+static json runClient(const std::string& address, unsigned rank) {
+    tl::engine engine(address.substr(0, address.find(':')), THALLIUM_CLIENT_MODE, true, 0);
+    json results;
+    try {
+        alpha::Client client(engine, g_client_config);
+        auto handle = client.makeResourceHandle(address, g_provider_id, true);
+
+        auto mix = parseMix(g_mix);
+        std::vector<double> weights;
+        std::vector<std::vector<int32_t>> xs, ys;
+        std::vector<std::unique_ptr<ResultBuffers>> results_buffers;
+        for(auto& entry : mix) {
+            weights.push_back(entry.weight);
+            xs.emplace_back(entry.elements, 1);
+            ys.emplace_back(entry.elements, 2);
+            results_buffers.push_back(std::make_unique<ResultBuffers>(entry.elements));
+        }
+
+        auto pool = tl::pool::create(tl::pool::access::mpmc);
+        std::vector<tl::managed<tl::xstream>> xstreams;
+        for(unsigned i = 0; i < g_num_xstreams; ++i)
+            xstreams.push_back(tl::xstream::create(tl::scheduler::predef::basic_wait, *pool));
+
+        const size_t num_seconds = static_cast<size_t>(std::ceil(g_duration));
+        std::vector<alpha::Histogram> per_second;
+        per_second.reserve(num_seconds);
+        for(size_t s = 0; s < num_seconds; ++s) per_second.emplace_back();
+
+        std::mt19937_64 rng(g_seed + rank);
+        std::discrete_distribution<size_t> pick_size(weights.begin(), weights.end());
+        const double rate = g_rate / g_num_processes;
+        std::exponential_distribution<double> poisson(rate);
+        const bool use_poisson = g_arrival == "poisson";
+
+        std::atomic<size_t> outstanding = 0;
+        std::atomic<size_t> errors = 0;
+        size_t sent = 0;
+        std::vector<clock_type::time_point> skipped;
+
+        const auto start = clock_type::now();
+        const auto end   = start + std::chrono::duration<double>(g_duration);
+        auto intended    = start;
+        while(true) {
+            double interval = use_poisson ? poisson(rng) : 1.0 / rate;
+            intended += std::chrono::duration_cast<clock_type::duration>(
+                std::chrono::duration<double>(interval));
+            if(intended >= end) break;
+            // sleep until shortly before the intended time, then yield
+            auto ahead = std::chrono::duration<double, std::milli>(intended - clock_type::now()).count();
+            if(ahead > 1.0) tl::thread::sleep(engine, ahead - 0.5);
+            while(clock_type::now() < intended) tl::thread::yield();
+
+            if(outstanding.load() >= g_max_outstanding) {
+                // the provider has collapsed, do not let the number of ULTs grow
+                skipped.push_back(intended);
+                continue;
+            }
+            auto size_index = pick_size(rng);
+            auto second = static_cast<size_t>(
+                std::chrono::duration<double>(intended - start).count());
+            outstanding += 1;
+            sent += 1;
+            pool->make_thread([&, size_index, second, intended]() {
+                try {
+                    if(mix[size_index].elements == 0) {
+                        handle.computeSum(1, 2).wait();
+                    } else {
+                        auto& buffers = *results_buffers[size_index];
+                        auto r = buffers.acquire();
+                        handle.computeSums(xs[size_index], ys[size_index], r).wait();
+                        buffers.release(std::move(r));
+                    }
+                } catch(const alpha::Exception&) {
+                    errors += 1;
+                }
+                // latency is measured from the intended send time
+                auto latency = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    clock_type::now() - intended).count();
+                per_second[std::min(second, num_seconds - 1)].record(latency);
+                outstanding -= 1;
+            }, tl::anonymous());
+        }
+        while(outstanding.load() != 0) tl::thread::sleep(engine, 1.0);
+        for(auto& xstream : xstreams) xstream->join();
+
+        // skipped requests had not completed by the end of the run
+        const auto finished = clock_type::now();
+        std::vector<size_t> skipped_per_second(num_seconds, 0);
+        for(auto& intended : skipped) {
+            auto second = std::min(num_seconds - 1, static_cast<size_t>(
+                std::chrono::duration<double>(intended - start).count()));
+            per_second[second].record(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                finished - intended).count());
+            skipped_per_second[second] += 1;
+        }
+
+        results["sent"] = sent;
+        results["skipped"] = skipped.size();
+        results["errors"] = errors.load();
+        results["per_second"] = json::array();
+        for(auto& h : per_second) results["per_second"].push_back(h.toJson());
+        results["skipped_per_second"] = skipped_per_second;
+
+    } catch(const alpha::Exception& ex) {
+        results["error"] = ex.what();
+    }
+    engine.finalize();
+    return results;
+}
+
+int main(int argc, char** argv) {
+    parse_command_line(argc, argv);
+    spdlog::set_default_logger(spdlog::stderr_color_mt("alpha-load-generator"));
+    spdlog::set_level(spdlog::level::from_str(g_log_level));
+
+    // The client processes are forked before any engine is initialized,
+    // since Mercury and Argobots do not support being forked. If the
+    // provider runs in the parent, its address is sent to the children
+    // through a pipe once it is known.
+    std::vector<pid_t> children;
+    std::vector<int> address_pipes, result_pipes;
+    for(unsigned rank = 0; rank < g_num_processes; ++rank) {
+        int address_pipe[2], result_pipe[2];
+        if(pipe(address_pipe) != 0 || pipe(result_pipe) != 0) {
+            perror("pipe");
+            exit(-1);
+        }
+        auto pid = fork();
+        if(pid < 0) {
+            perror("fork");
+            exit(-1);
+        }
+        if(pid == 0) {
+            close(address_pipe[1]);
+            close(result_pipe[0]);
+            std::string address;
+            char buffer[256];
+            ssize_t n;
+            while((n = read(address_pipe[0], buffer, sizeof(buffer))) > 0)
+                address.append(buffer, n);
+            close(address_pipe[0]);
+            auto results = runClient(address, rank).dump();
+            size_t written = 0;
+            while(written < results.size()) {
+                auto w = write(result_pipe[1], results.data() + written, results.size() - written);
+                if(w <= 0) break;
+                written += w;
+            }
+            close(result_pipe[1]);
+            _exit(0);
+        }
+        close(address_pipe[0]);
+        close(result_pipe[1]);
+        children.push_back(pid);
+        address_pipes.push_back(address_pipe[1]);
+        result_pipes.push_back(result_pipe[0]);
+    }
+
+    std::optional<tl::engine> engine;
+    std::optional<alpha::Provider> provider;
+    std::string address = g_address;
+    if(address.empty()) {
+        engine.emplace(g_protocol, THALLIUM_SERVER_MODE, true, g_num_xstreams);
+        provider.emplace(*engine, g_provider_id, g_provider_config);
+        address = static_cast<std::string>(engine->self());
+    }
+    spdlog::info("Generating load against provider {} at {} with {} processes",
+                 g_provider_id, address, g_num_processes);
+    for(auto fd : address_pipes) {
+        if(write(fd, address.data(), address.size()) != static_cast<ssize_t>(address.size()))
+            perror("write");
+        close(fd);
+    }
+
+    // merge the results of all the client processes
+    const size_t num_seconds = static_cast<size_t>(std::ceil(g_duration));
+    std::vector<alpha::Histogram> per_second;
+    per_second.reserve(num_seconds);
+    for(size_t s = 0; s < num_seconds; ++s) per_second.emplace_back();
+    std::vector<size_t> skipped_per_second(num_seconds, 0);
+    alpha::Histogram overall;
+    size_t sent = 0, skipped = 0, errors = 0;
+    for(unsigned rank = 0; rank < g_num_processes; ++rank) {
+        std::string content;
+        char buffer[4096];
+        ssize_t n;
+        while((n = read(result_pipes[rank], buffer, sizeof(buffer))) > 0)
+            content.append(buffer, n);
+        close(result_pipes[rank]);
+        waitpid(children[rank], nullptr, 0);
+        auto results = json::parse(content, nullptr, false);
+        if(results.is_discarded() || results.contains("error")) {
+            spdlog::error("Client process {} failed: {}", rank,
+                results.is_discarded() ? std::string{"no results"} : results["error"].get<std::string>());
+            continue;
+        }
+        sent    += results["sent"].get<size_t>();
+        skipped += results["skipped"].get<size_t>();
+        errors  += results["errors"].get<size_t>();
+        for(size_t s = 0; s < num_seconds && s < results["per_second"].size(); ++s) {
+            per_second[s].mergeJson(results["per_second"][s]);
+            overall.mergeJson(results["per_second"][s]);
+            skipped_per_second[s] += results["skipped_per_second"][s].get<size_t>();
+        }
+    }
+
+    json report;
+    report["config"] = {
+        {"address", address},
+        {"provider_id", g_provider_id},
+        {"rate", g_rate},
+        {"duration", g_duration},
+        {"arrival", g_arrival},
+        {"mix", g_mix},
+        {"num_processes", g_num_processes}
+    };
+    report["sent"] = sent;
+    report["skipped"] = skipped;
+    report["errors"] = errors;
+    report["latency_ns"] = overall.summary();
+    report["latency_ns"]["lower_bound"] = skipped != 0;
+    report["per_second"] = json::array();
+    for(size_t s = 0; s < num_seconds; ++s) {
+        auto summary = per_second[s].summary();
+        summary["second"] = s;
+        summary["skipped"] = skipped_per_second[s];
+        summary["lower_bound"] = skipped_per_second[s] != 0;
+        report["per_second"].push_back(std::move(summary));
+    }
+    if(skipped != 0)
+        spdlog::warn("{} requests were skipped because max-outstanding was reached, "
+                     "the latencies of the seconds in which they were due are lower bounds",
+                     skipped);
+    if(provider) {
+        report["provider_stats"] = json::parse(provider->getStats());
+        provider.reset();
+        engine->finalize();
+    }
+
+    if(g_output == "-") {
+        std::cout << report.dump(4) << std::endl;
+    } else {
+        std::ofstream out(g_output);
+        out << report.dump(4) << std::endl;
+    }
+    return 0;
+}
+
+void parse_command_line(int argc, char** argv) {
+    try {
+        TCLAP::CmdLine cmd("Alpha open-loop load generator", ' ', "0.1");
+        TCLAP::ValueArg<std::string> addressArg("a","address","Address of the server (default: start a provider in-process)", false,"","string");
+        TCLAP::ValueArg<std::string> protocolArg("P","protocol","Protocol to use for the in-process provider (default na+sm)", false,"na+sm","string");
+        TCLAP::ValueArg<unsigned>    providerArg("p", "provider", "Provider id (default 0)", false, 0, "int");
+        TCLAP::ValueArg<std::string> providerConfigArg("c", "provider-config", "JSON configuration of the in-process provider", false,
+                                                       R"({"resource":{"type":"dummy"}})", "json");
+        TCLAP::ValueArg<std::string> clientConfigArg("C", "client-config", "JSON configuration of the clients", false, "{}", "json");
+        TCLAP::ValueArg<double>      rateArg("r", "rate", "Target number of requests per second, over all processes (default 1000)", false, 1000.0, "float");
+        TCLAP::ValueArg<double>      durationArg("d", "duration", "Duration of the run in seconds (default 10)", false, 10.0, "float");
+        TCLAP::ValueArg<std::string> arrivalArg("A", "arrival", "Arrival process: constant or poisson (default poisson)", false, "poisson", "string");
+        TCLAP::ValueArg<std::string> mixArg("m", "mix", "Size mix as elements:weight pairs, 0 for computeSum (default 0:1)", false, "0:1", "string");
+        TCLAP::ValueArg<unsigned>    processesArg("n", "num-processes", "Number of client processes (default 1)", false, 1, "int");
+        TCLAP::ValueArg<unsigned>    xstreamsArg("x", "num-xstreams", "Number of execution streams per process (default 4)", false, 4, "int");
+        TCLAP::ValueArg<size_t>      outstandingArg("O", "max-outstanding", "Maximum number of outstanding requests per process (default 100000)", false, 100000, "int");
+        TCLAP::ValueArg<unsigned>    seedArg("s", "seed", "Random seed (default 0)", false, 0, "int");
+        TCLAP::ValueArg<std::string> outputArg("o", "output", "Output file, - for stdout (default -)", false, "-", "string");
+        TCLAP::ValueArg<std::string> logLevel("v","verbose", "Log level (trace, debug, info, warning, error, critical, off)", false, "info", "string");
+        cmd.add(addressArg);
+        cmd.add(protocolArg);
+        cmd.add(providerArg);
+        cmd.add(providerConfigArg);
+        cmd.add(clientConfigArg);
+        cmd.add(rateArg);
+        cmd.add(durationArg);
+        cmd.add(arrivalArg);
+        cmd.add(mixArg);
+        cmd.add(processesArg);
+        cmd.add(xstreamsArg);
+        cmd.add(outstandingArg);
+        cmd.add(seedArg);
+        cmd.add(outputArg);
+        cmd.add(logLevel);
+        cmd.parse(argc, argv);
+        g_address = addressArg.getValue();
+        g_protocol = protocolArg.getValue();
+        g_provider_id = providerArg.getValue();
+        g_provider_config = providerConfigArg.getValue();
+        g_client_config = clientConfigArg.getValue();
+        g_rate = rateArg.getValue();
+        g_duration = durationArg.getValue();
+        g_arrival = arrivalArg.getValue();
+        g_mix = mixArg.getValue();
+        g_num_processes = std::max(processesArg.getValue(), 1u);
+        g_num_xstreams = std::max(xstreamsArg.getValue(), 1u);
+        g_max_outstanding = std::max<size_t>(outstandingArg.getValue(), 1);
+        g_seed = seedArg.getValue();
+        g_output = outputArg.getValue();
+        g_log_level = logLevel.getValue();
+        if(g_rate <= 0.0 || g_duration <= 0.0)
+            throw TCLAP::ArgException("rate and duration should be positive", "rate");
+        if(g_arrival != "constant" && g_arrival != "poisson")
+            throw TCLAP::ArgException("should be constant or poisson", "arrival");
+        parseMix(g_mix);
+    } catch(TCLAP::ArgException &e) {
+        std::cerr << "error: " << e.error() << " for arg " << e.argId() << std::endl;
+        exit(-1);
+    } catch(const std::exception& e) {
+        std::cerr << "error: invalid size mix: " << e.what() << std::endl;
+        exit(-1);
+    }
+}
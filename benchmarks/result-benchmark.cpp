@@ -0,0 +1,276 @@
+/*
+ * (C) 2024 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#include <alpha/Result.hpp>
+#include <cereal/archives/binary.hpp>
+#include <nlohmann/json.hpp>
+#include <tclap/CmdLine.h>
+#include <thallium.hpp>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <istream>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+using json = nlohmann::json;
+using clock_type = std::chrono::steady_clock;
+
+static size_t      g_iterations;
+static size_t      g_rpc_iterations;
+static std::string g_protocol;
+static std::string g_output;
+
+static void parse_command_line(int argc, char** argv);
+
+// TUTORIAL
+// ********
+//
+// alpha-result-benchmark measures the cost of building, serializing, and
+// deserializing the Result objects sent back by every RPC, for the current
+// Result class ("compact") and for a copy of its previous implementation
+// ("legacy"), which held a std::string even on success and serialized a bool,
+// then the value or the error. Both are serialized with cereal's binary
+// archives into a preallocated buffer, so that the measurements only include
+// the Result's own work. It outputs the size of the object, the number of
+// bytes it is serialized into, and the time per operation (in nanoseconds)
+// for Result<int32_t> and Result<void>.
+//
+// It then measures the same Results on the path they actually take: each is
+// sent as the response of an RPC that a thallium engine sends to itself, so it
+// goes through thallium's proc archives and Mercury's encoding of the response.
+// The average round trip (in nanoseconds) includes the cost of the RPC itself,
+// which is the same for both implementations.
+
+namespace {
+
+template<typename T>
+class LegacyResult {
+
+    public:
+
+    bool& success() { return m_success; }
+    std::string& error() { return m_error; }
+    T& value() { return m_value; }
+
+    template<typename Archive>
+    void serialize(Archive& a) {
+        a & m_success;
+        if(m_success) {
+            a & m_value;
+        } else {
+            a & m_error;
+        }
+    }
+
+    private:
+
+    bool        m_success = true;
+    std::string m_error   = "";
+    T           m_value;
+};
+
+template<>
+class LegacyResult<void> {
+
+    public:
+
+    bool& success() { return m_success; }
+    std::string& error() { return m_error; }
+
+    template<typename Archive>
+    void serialize(Archive& a) {
+        a & m_success;
+        if(!m_success) {
+            a & m_error;
+        }
+    }
+
+    private:
+
+    bool        m_success = true;
+    std::string m_error   = "";
+};
+
+/**
+ * @brief Stream buffer over a preallocated array, rewound before each
+ * operation so that serialization never allocates.
+ */
+class FixedBuffer : public std::streambuf {
+
+    public:
+
+    explicit FixedBuffer(size_t size)
+    : m_data(size) {
+        rewindOutput();
+        rewindInput();
+    }
+
+    void rewindOutput() {
+        setp(m_data.data(), m_data.data() + m_data.size());
+    }
+
+    void rewindInput() {
+        setg(m_data.data(), m_data.data(), m_data.data() + m_data.size());
+    }
+
+    size_t written() const {
+        return static_cast<size_t>(pptr() - pbase());
+    }
+
+    private:
+
+    std::vector<char> m_data;
+};
+
+template<typename R>
+static json measure(size_t iterations) {
+    FixedBuffer  buffer{4096};
+    std::ostream os{&buffer};
+    std::istream is{&buffer};
+    cereal::BinaryOutputArchive oa{os};
+    cereal::BinaryInputArchive  ia{is};
+    uint64_t checksum = 0;
+
+    auto start = clock_type::now();
+    for(size_t i = 0; i < iterations; ++i) {
+        buffer.rewindOutput();
+        R result;
+        if constexpr (requires { result.value(); })
+            result.value() = static_cast<int32_t>(i);
+        oa(result);
+    }
+    auto serialize_time = clock_type::now() - start;
+    auto bytes = buffer.written();
+
+    start = clock_type::now();
+    for(size_t i = 0; i < iterations; ++i) {
+        buffer.rewindInput();
+        R result;
+        ia(result);
+        checksum += result.success();
+        if constexpr (requires { result.value(); })
+            checksum += static_cast<uint64_t>(result.value());
+    }
+    auto deserialize_time = clock_type::now() - start;
+
+    auto per_op = [iterations](auto duration) {
+        return std::chrono::duration<double, std::nano>(duration).count() / iterations;
+    };
+    return json{
+        {"object_bytes", sizeof(R)},
+        {"bytes", bytes},
+        {"serialize_ns", per_op(serialize_time)},
+        {"deserialize_ns", per_op(deserialize_time)},
+        {"checksum", checksum}
+    };
+}
+
+/**
+ * @brief Measure the round trip of an RPC responding with an R,
+ * sent by the engine to itself.
+ */
+template<typename R>
+static json measureRPC(thallium::engine& engine, const std::string& name, size_t iterations) {
+    std::function<void(const thallium::request&)> respond = [](const thallium::request& req) {
+        R result;
+        if constexpr (requires { result.value(); })
+            result.value() = 42;
+        req.respond(result);
+    };
+    auto rpc = engine.define(name, respond);
+    auto self = engine.self();
+    uint64_t checksum = 0;
+    auto call = [&]() {
+        R result = rpc.on(self)();
+        checksum += result.success();
+        if constexpr (requires { result.value(); })
+            checksum += static_cast<uint64_t>(result.value());
+    };
+    for(size_t i = 0; i < std::min<size_t>(iterations, 1000); ++i) call();
+
+    auto start = clock_type::now();
+    for(size_t i = 0; i < iterations; ++i) call();
+    auto elapsed = clock_type::now() - start;
+    rpc.deregister();
+    return json{
+        {"round_trip_ns", std::chrono::duration<double, std::nano>(elapsed).count() / iterations},
+        {"checksum", checksum}
+    };
+}
+
+}
+
+int main(int argc, char** argv) {
+    parse_command_line(argc, argv);
+
+    json results = json::object();
+    results["iterations"] = g_iterations;
+    results["Result<int32_t>"] = {
+        {"legacy", measure<LegacyResult<int32_t>>(g_iterations)},
+        {"compact", measure<alpha::Result<int32_t>>(g_iterations)}
+    };
+    results["Result<void>"] = {
+        {"legacy", measure<LegacyResult<void>>(g_iterations)},
+        {"compact", measure<alpha::Result<void>>(g_iterations)}
+    };
+
+    if(g_rpc_iterations != 0) {
+        thallium::engine engine{g_protocol, THALLIUM_SERVER_MODE, true, 1};
+        results["rpc"] = {
+            {"protocol", g_protocol},
+            {"iterations", g_rpc_iterations},
+            {"Result<int32_t>", {
+                {"legacy", measureRPC<LegacyResult<int32_t>>(engine, "legacy_int32", g_rpc_iterations)},
+                {"compact", measureRPC<alpha::Result<int32_t>>(engine, "compact_int32", g_rpc_iterations)}
+            }},
+            {"Result<void>", {
+                {"legacy", measureRPC<LegacyResult<void>>(engine, "legacy_void", g_rpc_iterations)},
+                {"compact", measureRPC<alpha::Result<void>>(engine, "compact_void", g_rpc_iterations)}
+            }}
+        };
+        engine.finalize();
+    }
+
+    if(g_output.empty() || g_output == "-") {
+        std::cout << results.dump(4) << std::endl;
+    } else {
+        std::ofstream out{g_output};
+        out << results.dump(4) << std::endl;
+    }
+    return 0;
+}
+
+void parse_command_line(int argc, char** argv) {
+    try {
+        TCLAP::CmdLine cmd("Alpha Result serialization benchmark", ' ', "0.1");
+        TCLAP::ValueArg<size_t> iterationsArg(
+            "n", "iterations", "Number of operations per measurement", false, 10000000, "int");
+        TCLAP::ValueArg<size_t> rpcIterationsArg(
+            "r", "rpc-iterations", "Number of RPCs per round trip measurement (0 to skip them)",
+            false, 100000, "int");
+        TCLAP::ValueArg<std::string> protocolArg(
+            "p", "protocol", "Protocol used for the RPCs (default na+sm)", false, "na+sm", "string");
+        TCLAP::ValueArg<std::string> outputArg(
+            "o", "output", "File in which to write the JSON results (- for stdout)",
+            false, "-", "string");
+        cmd.add(iterationsArg);
+        cmd.add(rpcIterationsArg);
+        cmd.add(protocolArg);
+        cmd.add(outputArg);
+        cmd.parse(argc, argv);
+        g_iterations     = iterationsArg.getValue();
+        g_rpc_iterations = rpcIterationsArg.getValue();
+        g_protocol       = protocolArg.getValue();
+        g_output         = outputArg.getValue();
+    } catch(TCLAP::ArgException& e) {
+        std::cerr << "error: " << e.error() << " for arg " << e.argId() << std::endl;
+        exit(-1);
+    }
+}
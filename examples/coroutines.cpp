@@ -0,0 +1,132 @@
+/*
+ * (C) 2024 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#include <alpha/Client.hpp>
+#include <alpha/Task.hpp>
+#include <spdlog/spdlog.h>
+#include <tclap/CmdLine.h>
+#include <atomic>
+#include <iostream>
+#include <vector>
+
+namespace tl = thallium;
+
+static std::string g_address;
+static std::string g_protocol;
+static unsigned    g_provider_id;
+static unsigned    g_num_threads;
+static unsigned    g_num_operations;
+static std::string g_log_level = "info";
+
+static void parse_command_line(int argc, char** argv);
+
+/**
+ * @brief Keeps track of the number of coroutines still running
+ * and of the number of incorrect results.
+ */
+struct Counters {
+    std::atomic<unsigned> remaining;
+    std::atomic<unsigned> errors = 0;
+    tl::eventual<void>    done;
+
+    void finish() {
+        if(remaining.fetch_sub(1) == 1) done.set_value();
+    }
+};
+
+/**
+ * @brief Coroutine issuing a computeSum followed by a computeSums.
+ * Each co_await suspends the coroutine without blocking the ULT that
+ * started it, so a single ULT can have many operations in flight.
+ */
+static alpha::Task run(alpha::ResourceHandle resource, int32_t i, Counters& counters) {
+    try {
+        int32_t sum = co_await resource.computeSum(i, 1);
+        if(sum != i + 1) counters.errors += 1;
+
+        std::vector<int32_t> x(64, i), y(64, sum), result(64);
+        co_await resource.computeSums(x, y, result);
+        for(auto r : result) {
+            if(r != 2*i + 1) {
+                counters.errors += 1;
+                break;
+            }
+        }
+    } catch(const alpha::Exception& ex) {
+        spdlog::error("Operation {} failed: {}", i, ex.what());
+        counters.errors += 1;
+    }
+    counters.finish();
+}
+
+int main(int argc, char** argv) {
+    parse_command_line(argc, argv);
+    spdlog::set_level(spdlog::level::from_str(g_log_level));
+
+    tl::engine engine(g_protocol, THALLIUM_CLIENT_MODE);
+
+    try {
+
+        alpha::Client client(engine);
+        alpha::ResourceHandle resource =
+            client.makeResourceHandle(g_address, g_provider_id);
+
+        Counters counters;
+        counters.remaining = g_num_operations;
+
+        // Each execution stream gets one ULT that starts its share of the
+        // coroutines. The coroutines are resumed in the execution stream
+        // that started them.
+        std::vector<tl::managed<tl::pool>>    pools;
+        std::vector<tl::managed<tl::xstream>> xstreams;
+        for(unsigned t = 0; t < g_num_threads; ++t) {
+            pools.push_back(tl::pool::create(tl::pool::access::mpmc));
+            xstreams.push_back(tl::xstream::create(tl::scheduler::predef::deflt, *pools.back()));
+            pools.back()->make_thread([&resource, &counters, t]() {
+                for(unsigned i = t; i < g_num_operations; i += g_num_threads)
+                    run(resource, static_cast<int32_t>(i), counters);
+            }, tl::anonymous());
+        }
+
+        counters.done.wait();
+        for(auto& xstream : xstreams) xstream->join();
+
+        spdlog::info("Completed {} operations from {} threads, {} errors",
+                     g_num_operations, g_num_threads, counters.errors.load());
+        if(counters.errors != 0) exit(-1);
+
+    } catch(const alpha::Exception& ex) {
+        std::cerr << ex.what() << std::endl;
+        exit(-1);
+    }
+
+    return 0;
+}
+
+void parse_command_line(int argc, char** argv) {
+    try {
+        TCLAP::CmdLine cmd("Alpha coroutines example", ' ', "0.1");
+        TCLAP::ValueArg<std::string> addressArg("a","address","Address or server", true,"","string");
+        TCLAP::ValueArg<unsigned>    providerArg("p", "provider", "Provider id to contact (default 0)", false, 0, "int");
+        TCLAP::ValueArg<unsigned>    threadsArg("t", "threads", "Number of execution streams (default 4)", false, 4, "int");
+        TCLAP::ValueArg<unsigned>    operationsArg("n", "operations", "Number of coroutines (default 10000)", false, 10000, "int");
+        TCLAP::ValueArg<std::string> logLevel("v","verbose", "Log level (trace, debug, info, warning, error, critical, off)", false, "info", "string");
+        cmd.add(addressArg);
+        cmd.add(providerArg);
+        cmd.add(threadsArg);
+        cmd.add(operationsArg);
+        cmd.add(logLevel);
+        cmd.parse(argc, argv);
+        g_address = addressArg.getValue();
+        g_provider_id = providerArg.getValue();
+        g_num_threads = std::max(threadsArg.getValue(), 1u);
+        g_num_operations = operationsArg.getValue();
+        g_log_level = logLevel.getValue();
+        g_protocol = g_address.substr(0, g_address.find(":"));
+    } catch(TCLAP::ArgException &e) {
+        std::cerr << "error: " << e.error() << " for arg " << e.argId() << std::endl;
+        exit(-1);
+    }
+}
@@ -0,0 +1,53 @@
+/*
+ * (C) 2024 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#ifndef __ALPHA_ARRAY_REF_HPP
+#define __ALPHA_ARRAY_REF_HPP
+
+#include <alpha/DataType.hpp>
+#include <cereal/types/string.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace alpha {
+
+// TUTORIAL
+// ********
+//
+// Iterative workloads often send the same operand to a provider over and over.
+// ResourceHandle::putArray uploads an array once into the memory of the provider,
+// under a name, and returns an ArrayRef that later operations can use in place of
+// the array (e.g. computeSums(x, y_ref, result)), so the provider does not pull it
+// again and the client does not need to expose it again.
+//
+// Each put of a name creates a new version of the array. An ArrayRef with a non-zero
+// version only refers to that version: operations using it fail once the array has
+// been replaced, dropped, or evicted (providers evict the least recently used arrays
+// when they exceed their configured limits), instead of silently using other data.
+// An ArrayRef with version 0 refers to the current version of the array.
+
+/**
+ * @brief Reference to an array stored by a provider on behalf of a resource.
+ */
+struct ArrayRef {
+
+    std::string name;
+    uint64_t    version = 0;
+    DataType    type    = DataType::Int32;
+    size_t      size    = 0; // in bytes
+
+    template<typename Archive>
+    void serialize(Archive& ar) {
+        ar(name);
+        ar(version);
+        ar(type);
+        ar(size);
+    }
+};
+
+}
+
+#endif
@@ -7,6 +7,8 @@
 #define __ALPHA_CLIENT_HPP
 
 #include <alpha/ResourceHandle.hpp>
+#include <alpha/RegisteredBuffer.hpp>
+#include <alpha/ResourceID.hpp>
 #include <thallium.hpp>
 #include <memory>
 
@@ -29,6 +31,15 @@ class ResourceHandle;
 // pointer to the ClientImpl that created them, it is safe for the Client
 // object that created them to get out of scope. It is also safe for multiple
 // Client objects to be created by the program.
+//
+// A provider may host multiple resources, identified by a ResourceID. The
+// makeResourceHandle overload that does not take a ResourceID targets the
+// resource with ResourceID 0 (the one in the provider's "resource" field).
+// Resources can also be created remotely using createResource.
+//
+// The Client can optionally be given a JSON-formatted configuration. For now
+// it only accepts a "registration_cache" field with a "capacity" subfield,
+// which enables caching the memory registrations done by computeSums.
 
 /**
  * @brief The Client object is the main object used to establish
@@ -49,15 +60,17 @@ class Client {
      * @brief Constructor using a margo instance id.
      *
      * @param mid Margo instance id.
+     * @param config JSON-formatted configuration.
      */
-    Client(margo_instance_id mid);
+    Client(margo_instance_id mid, const std::string& config = "{}");
 
     /**
      * @brief Constructor.
      *
      * @param engine Thallium engine.
+     * @param config JSON-formatted configuration.
      */
-    Client(const thallium::engine& engine);
+    Client(const thallium::engine& engine, const std::string& config = "{}");
 
     /**
      * @brief Copy constructor.
@@ -104,6 +117,61 @@ class Client {
                                       uint16_t provider_id,
                                       bool check = true) const;
 
+    /**
+     * @brief Same as above but targeting a specific resource
+     * of the provider. If "check" is true, this also checks that
+     * the resource exists.
+     *
+     * @param address Address of the provider holding the database.
+     * @param provider_id Provider id.
+     * @param resource_id Resource id.
+     * @param check Checks if the Resource exists by issuing an RPC.
+     *
+     * @return a ResourceHandle instance.
+     */
+    ResourceHandle makeResourceHandle(const std::string& address,
+                                      uint16_t provider_id,
+                                      ResourceID resource_id,
+                                      bool check = true) const;
+
+    /**
+     * @brief Creates a new resource in the specified provider
+     * and returns a handle to it.
+     *
+     * @param address Address of the provider.
+     * @param provider_id Provider id.
+     * @param type Type of resource.
+     * @param config JSON-formatted configuration of the resource.
+     *
+     * @return a ResourceHandle instance.
+     */
+    ResourceHandle createResource(const std::string& address,
+                                  uint16_t provider_id,
+                                  const std::string& type,
+                                  const std::string& config = "{}") const;
+
+    /**
+     * @brief Exposes a memory region for RDMA so that it can be
+     * used in multiple operations without registering it again.
+     * The memory must remain valid as long as the RegisteredBuffer
+     * (or any BulkLocation built from it) is in use.
+     *
+     * @param data Pointer to the memory.
+     * @param size Size of the memory, in bytes.
+     * @param mode Access mode the remote side needs.
+     *
+     * @return a RegisteredBuffer instance.
+     */
+    RegisteredBuffer registerBuffer(void* data, size_t size,
+                                    thallium::bulk_mode mode = thallium::bulk_mode::read_write) const;
+
+    /**
+     * @brief Drops all the memory registrations cached by the Client.
+     * This function must be called before freeing memory that may have
+     * been passed to computeSums while the registration cache is enabled.
+     */
+    void clearRegistrationCache() const;
+
     /**
      * @brief Checks that the Client instance is valid.
      */
@@ -116,6 +184,15 @@ class Client {
      */
     std::string getConfig() const;
 
+    /**
+     * @brief Return the spans recorded by the client's ResourceHandles
+     * if tracing is enabled in its configuration, in Chrome's JSON trace
+     * format (which can be loaded in chrome://tracing or ui.perfetto.dev).
+     *
+     * @return JSON formatted string.
+     */
+    std::string dumpTrace() const;
+
     private:
 
     Client(const std::shared_ptr<ClientImpl>& impl);
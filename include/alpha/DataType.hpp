@@ -0,0 +1,86 @@
+/*
+ * (C) 2024 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#ifndef __ALPHA_DATA_TYPE_HPP
+#define __ALPHA_DATA_TYPE_HPP
+
+#include <alpha/Exception.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace alpha {
+
+// TUTORIAL
+// ********
+//
+// Array operations (e.g. computeSums) support several element types, listed
+// in the DataType enum. When arrays are moved by RDMA, the DataType is sent
+// as a single byte along with the BulkLocations, and the provider dispatches
+// to the resource's computeSums overload for the corresponding C++ type using
+// visitDataType.
+
+/**
+ * @brief Type of the elements of an array.
+ */
+enum class DataType : uint8_t {
+    Int32   = 0,
+    Int64   = 1,
+    Float32 = 2,
+    Float64 = 3
+};
+
+/**
+ * @brief Maps a C++ type to its DataType.
+ */
+template<typename T> struct DataTypeOf;
+template<> struct DataTypeOf<int32_t> : std::integral_constant<DataType, DataType::Int32> {};
+template<> struct DataTypeOf<int64_t> : std::integral_constant<DataType, DataType::Int64> {};
+template<> struct DataTypeOf<float>   : std::integral_constant<DataType, DataType::Float32> {};
+template<> struct DataTypeOf<double>  : std::integral_constant<DataType, DataType::Float64> {};
+
+template<typename T>
+inline constexpr DataType dataTypeOf = DataTypeOf<T>::value;
+
+/**
+ * @brief Call f with a std::type_identity<T> for the C++ type T
+ * corresponding to the DataType, and return its result.
+ */
+template<typename F>
+decltype(auto) visitDataType(DataType type, F&& f) {
+    switch(type) {
+    case DataType::Int32:   return std::forward<F>(f)(std::type_identity<int32_t>{});
+    case DataType::Int64:   return std::forward<F>(f)(std::type_identity<int64_t>{});
+    case DataType::Float32: return std::forward<F>(f)(std::type_identity<float>{});
+    case DataType::Float64: return std::forward<F>(f)(std::type_identity<double>{});
+    }
+    throw Exception{"Invalid alpha::DataType " + std::to_string(static_cast<int>(type))};
+}
+
+/**
+ * @brief Size of an element of the specified DataType, in bytes.
+ */
+inline size_t sizeOf(DataType type) {
+    return visitDataType(type, [](auto t) { return sizeof(typename decltype(t)::type); });
+}
+
+/**
+ * @brief Name of the DataType (e.g. "int32").
+ */
+inline const char* toString(DataType type) {
+    switch(type) {
+    case DataType::Int32:   return "int32";
+    case DataType::Int64:   return "int64";
+    case DataType::Float32: return "float32";
+    case DataType::Float64: return "float64";
+    }
+    return "invalid";
+}
+
+}
+
+#endif
@@ -0,0 +1,421 @@
+/*
+ * (C) 2024 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#ifndef __ALPHA_EXPRESSION_HPP
+#define __ALPHA_EXPRESSION_HPP
+
+#include <alpha/DataType.hpp>
+#include <alpha/Result.hpp>
+#include <cereal/types/vector.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace alpha {
+
+// TUTORIAL
+// ********
+//
+// An Expression describes an element-wise computation over N input arrays,
+// for instance r = 2*x + y - z, so that a provider can compute it in a single
+// request, reading each input once and writing the result once, instead of
+// chaining computeSums calls that each pull and push whole arrays.
+//
+// Expressions are built with Expression::input(i) (the i-th input array),
+// constants, and the usual operators, and are stored as a postfix program:
+// a vector of Instructions executed by a stack machine. This is also their
+// serialized form. For example:
+//
+//   auto x = Expression::input(0), y = Expression::input(1), z = Expression::input(2);
+//   auto e = 2.0*x + y - z;   // input 0, constant 2, mul, input 1, add, input 2, sub
+//
+// The program is interpreted over blocks of s_block_size elements rather than
+// element by element (see evaluateKernel): each instruction is a simple loop
+// over a block, which the compiler vectorizes, and the intermediate values stay
+// in small buffers that remain in the L1 cache. The cost of dispatching each
+// instruction is thus amortized over the block.
+//
+// Arithmetic on integer arrays wraps around on overflow, like computeSums.
+// Division is only supported for floating-point arrays.
+
+/**
+ * @brief Element-wise expression over input arrays.
+ */
+class Expression {
+
+    public:
+
+    /**
+     * @brief Operation of an Instruction.
+     */
+    enum class OpCode : uint8_t {
+        Input    = 0, // push the input array given by Instruction::input
+        Constant = 1, // push Instruction::constant
+        Add      = 2, // pop b, pop a, push a + b
+        Sub      = 3, // pop b, pop a, push a - b
+        Mul      = 4, // pop b, pop a, push a * b
+        Div      = 5, // pop b, pop a, push a / b
+        Min      = 6, // pop b, pop a, push min(a, b)
+        Max      = 7, // pop b, pop a, push max(a, b)
+        Neg      = 8  // pop a, push -a
+    };
+
+    /**
+     * @brief Instruction of the postfix program.
+     */
+    struct Instruction {
+
+        OpCode   op       = OpCode::Constant;
+        uint32_t input    = 0;
+        double   constant = 0;
+
+        template<typename Archive>
+        void serialize(Archive& a) {
+            a(op, input, constant);
+        }
+    };
+
+    static constexpr size_t s_max_inputs = 16;
+    static constexpr size_t s_max_depth  = 16;
+    static constexpr size_t s_max_size   = 256;
+    static constexpr size_t s_block_size = 256;
+    // registers used by the interpreter: one per stack entry, plus the output
+    static constexpr size_t s_num_registers = s_max_depth + 1;
+
+    /**
+     * @brief Constructor. The resulting Expression is empty, hence invalid.
+     */
+    Expression() = default;
+
+    /**
+     * @brief Constructor of a constant expression (implicit, so that
+     * constants can be used directly with the operators).
+     */
+    Expression(double value)
+    : m_code{Instruction{OpCode::Constant, 0, value}} {}
+
+    /**
+     * @brief Expression representing the input array at the given index.
+     */
+    static Expression input(uint32_t index) {
+        Expression e;
+        e.m_code.push_back(Instruction{OpCode::Input, index, 0});
+        return e;
+    }
+
+    /**
+     * @brief Expression representing a constant.
+     */
+    static Expression constant(double value) {
+        return Expression{value};
+    }
+
+    /**
+     * @brief Element-wise minimum of two expressions.
+     */
+    static Expression min(Expression a, const Expression& b) {
+        return binary(std::move(a), b, OpCode::Min);
+    }
+
+    /**
+     * @brief Element-wise maximum of two expressions.
+     */
+    static Expression max(Expression a, const Expression& b) {
+        return binary(std::move(a), b, OpCode::Max);
+    }
+
+    friend Expression operator+(Expression a, const Expression& b) {
+        return binary(std::move(a), b, OpCode::Add);
+    }
+
+    friend Expression operator-(Expression a, const Expression& b) {
+        return binary(std::move(a), b, OpCode::Sub);
+    }
+
+    friend Expression operator*(Expression a, const Expression& b) {
+        return binary(std::move(a), b, OpCode::Mul);
+    }
+
+    friend Expression operator/(Expression a, const Expression& b) {
+        return binary(std::move(a), b, OpCode::Div);
+    }
+
+    friend Expression operator-(Expression a) {
+        a.m_code.push_back(Instruction{OpCode::Neg, 0, 0});
+        return a;
+    }
+
+    /**
+     * @brief Postfix program of the expression.
+     */
+    const std::vector<Instruction>& code() const {
+        return m_code;
+    }
+
+    /**
+     * @brief Number of input arrays the expression uses
+     * (i.e. the largest input index plus one).
+     */
+    size_t numInputs() const {
+        size_t n = 0;
+        for(auto& ins : m_code)
+            if(ins.op == OpCode::Input) n = std::max<size_t>(n, ins.input + 1);
+        return n;
+    }
+
+    /**
+     * @brief Check that the expression can be evaluated over num_inputs
+     * arrays of the specified type. Returns an error message, or an empty
+     * string if the expression is valid.
+     */
+    std::string check(size_t num_inputs, DataType type) const {
+        if(num_inputs > s_max_inputs)
+            return "Expressions are limited to " + std::to_string(s_max_inputs) + " inputs";
+        if(m_code.empty())
+            return "Empty expression";
+        if(m_code.size() > s_max_size)
+            return "Expressions are limited to " + std::to_string(s_max_size) + " instructions";
+        const bool integral = type == DataType::Int32 || type == DataType::Int64;
+        size_t depth = 0;
+        for(auto& ins : m_code) {
+            switch(ins.op) {
+            case OpCode::Input:
+                if(ins.input >= num_inputs)
+                    return "Expression uses input " + std::to_string(ins.input)
+                         + " but only " + std::to_string(num_inputs) + " inputs were provided";
+                depth += 1;
+                break;
+            case OpCode::Constant:
+                if(integral && !representable(ins.constant, type))
+                    return "Constant " + std::to_string(ins.constant) + " is not a valid "
+                         + toString(type) + " value";
+                depth += 1;
+                break;
+            case OpCode::Div:
+                if(integral)
+                    return std::string{"Division is not supported for "} + toString(type) + " arrays";
+                [[fallthrough]];
+            case OpCode::Add:
+            case OpCode::Sub:
+            case OpCode::Mul:
+            case OpCode::Min:
+            case OpCode::Max:
+                if(depth < 2) return "Malformed expression";
+                depth -= 1;
+                break;
+            case OpCode::Neg:
+                if(depth < 1) return "Malformed expression";
+                break;
+            default:
+                return "Invalid expression instruction";
+            }
+            if(depth > s_max_depth)
+                return "Expressions are limited to a depth of " + std::to_string(s_max_depth);
+        }
+        if(depth != 1) return "Malformed expression";
+        return {};
+    }
+
+    template<typename Archive>
+    void serialize(Archive& a) {
+        a(m_code);
+    }
+
+    private:
+
+    static Expression binary(Expression a, const Expression& b, OpCode op) {
+        a.m_code.insert(a.m_code.end(), b.m_code.begin(), b.m_code.end());
+        a.m_code.push_back(Instruction{op, 0, 0});
+        return a;
+    }
+
+    static bool representable(double value, DataType type) {
+        if(!std::isfinite(value) || std::trunc(value) != value) return false;
+        if(type == DataType::Int32)
+            return value >= std::numeric_limits<int32_t>::min()
+                && value <= std::numeric_limits<int32_t>::max();
+        // 2^63 is the first double above the largest int64_t
+        return value >= -9223372036854775808.0 && value < 9223372036854775808.0;
+    }
+
+    std::vector<Instruction> m_code;
+};
+
+namespace detail {
+
+template<typename T, typename F>
+[[gnu::always_inline]] inline void applyUnary(const T* a, T* __restrict r, size_t n, F&& f) {
+    for(size_t i = 0; i < n; ++i) r[i] = f(a[i]);
+}
+
+template<typename T, typename F>
+[[gnu::always_inline]] inline void applyBinary(const T* a, const T* b, T* __restrict r, size_t n, F&& f) {
+    for(size_t i = 0; i < n; ++i) r[i] = f(a[i], b[i]);
+}
+
+template<typename T, typename F>
+[[gnu::always_inline]] inline void applyWrapping(const T* a, const T* b, T* __restrict r, size_t n, F&& f) {
+    using U = std::make_unsigned_t<T>;
+    applyBinary(a, b, r, n, [&f](T u, T v) { return static_cast<T>(f(static_cast<U>(u), static_cast<U>(v))); });
+}
+
+/**
+ * @brief Evaluate the Expression over m elements (at most s_block_size)
+ * starting at the specified offset. The main loop of evaluateKernel calls it
+ * with m = s_block_size, a constant once inlined, so that the loops of each
+ * instruction have a known trip count and are vectorized without epilogues.
+ */
+template<typename T>
+[[gnu::always_inline]] inline void evaluateBlock(const Expression& expr,
+                                                 const T* const* inputs,
+                                                 T* result, size_t begin, size_t m,
+                                                 T* registers) {
+    using OpCode = Expression::OpCode;
+    constexpr size_t B = Expression::s_block_size;
+    constexpr size_t s_none = Expression::s_num_registers;
+    auto& code = expr.code();
+    // Each stack entry points either to an input array or to a register it
+    // owns. Operations write into a free register (or into the result for
+    // the last instruction), so their output never aliases their operands,
+    // and release the registers of their operands.
+    const T* stack[Expression::s_max_depth];
+    size_t owner[Expression::s_max_depth];
+    size_t free_registers[Expression::s_num_registers];
+    size_t num_free = 0;
+    for(size_t k = 0; k < Expression::s_num_registers; ++k) free_registers[num_free++] = k;
+    auto release = [&](size_t k) { if(k != s_none) free_registers[num_free++] = k; };
+    size_t sp = 0;
+    for(size_t pc = 0; pc < code.size(); ++pc) {
+        auto& ins = code[pc];
+        if(ins.op == OpCode::Input) {
+            stack[sp] = inputs[ins.input] + begin;
+            owner[sp++] = s_none;
+            continue;
+        }
+        size_t reg = s_none;
+        T* out = result + begin;
+        if(pc + 1 != code.size()) {
+            reg = free_registers[--num_free];
+            out = registers + reg*B;
+        }
+        if(ins.op == OpCode::Constant) {
+            std::fill(out, out + m, static_cast<T>(ins.constant));
+            stack[sp] = out;
+            owner[sp++] = reg;
+            continue;
+        }
+        if(ins.op == OpCode::Neg) {
+            if constexpr (std::is_integral_v<T>) {
+                using U = std::make_unsigned_t<T>;
+                applyUnary(stack[sp-1], out, m, [](T u) { return static_cast<T>(U{0} - static_cast<U>(u)); });
+            } else {
+                applyUnary(stack[sp-1], out, m, [](T u) { return -u; });
+            }
+            release(owner[sp-1]);
+            stack[sp-1] = out;
+            owner[sp-1] = reg;
+            continue;
+        }
+        const T* a = stack[sp-2];
+        const T* b = stack[sp-1];
+        if constexpr (std::is_integral_v<T>) {
+            switch(ins.op) {
+            case OpCode::Add: applyWrapping(a, b, out, m, [](auto u, auto v) { return u + v; }); break;
+            case OpCode::Sub: applyWrapping(a, b, out, m, [](auto u, auto v) { return u - v; }); break;
+            case OpCode::Mul: applyWrapping(a, b, out, m, [](auto u, auto v) { return u * v; }); break;
+            case OpCode::Min: applyBinary(a, b, out, m, [](T u, T v) { return std::min(u, v); }); break;
+            default:          applyBinary(a, b, out, m, [](T u, T v) { return std::max(u, v); }); break;
+            }
+        } else {
+            switch(ins.op) {
+            case OpCode::Add: applyBinary(a, b, out, m, [](T u, T v) { return u + v; }); break;
+            case OpCode::Sub: applyBinary(a, b, out, m, [](T u, T v) { return u - v; }); break;
+            case OpCode::Mul: applyBinary(a, b, out, m, [](T u, T v) { return u * v; }); break;
+            case OpCode::Div: applyBinary(a, b, out, m, [](T u, T v) { return u / v; }); break;
+            case OpCode::Min: applyBinary(a, b, out, m, [](T u, T v) { return std::min(u, v); }); break;
+            default:          applyBinary(a, b, out, m, [](T u, T v) { return std::max(u, v); }); break;
+            }
+        }
+        release(owner[sp-1]);
+        release(owner[sp-2]);
+        sp -= 1;
+        stack[sp-1] = out;
+        owner[sp-1] = reg;
+    }
+    // an expression made of a single input is a copy
+    if(stack[0] != result + begin)
+        std::copy(stack[0], stack[0] + m, result + begin);
+}
+
+}
+
+/**
+ * @brief Evaluate a (valid) Expression over the n elements of the input
+ * arrays, writing into result, which must not overlap the inputs. registers
+ * must point to a buffer of at least Expression::s_num_registers*s_block_size
+ * elements. This function is always inlined, so that backends can call it
+ * from functions compiled for a specific instruction set (e.g. with
+ * __attribute__((target("avx2")))).
+ */
+template<typename T>
+[[gnu::always_inline]] inline void evaluateKernel(const Expression& expr,
+                                                  const T* const* inputs,
+                                                  T* result, size_t n,
+                                                  T* registers) {
+    constexpr size_t B = Expression::s_block_size;
+    size_t begin = 0;
+    for(; begin + B <= n; begin += B)
+        detail::evaluateBlock(expr, inputs, result, begin, B, registers);
+    if(begin < n)
+        detail::evaluateBlock(expr, inputs, result, begin, n - begin, registers);
+}
+
+/**
+ * @brief Check that an Expression can be evaluated over the inputs
+ * into result. Returns false and sets the Result's error otherwise.
+ */
+template<typename T, typename R>
+bool checkExpressionArguments(const Expression& expr,
+                              std::span<const std::span<const T>> inputs,
+                              std::span<T> result, R& r) {
+    auto error = expr.check(inputs.size(), dataTypeOf<T>);
+    for(auto& input : inputs) {
+        if(error.empty() && input.size() != result.size())
+            error = "evaluate arguments must have the same size";
+    }
+    if(error.empty()) return true;
+    r.success() = false;
+    r.error() = std::move(error);
+    return false;
+}
+
+/**
+ * @brief Evaluate the Expression over the inputs into result. This portable
+ * implementation is used by the default implementation of
+ * ResourceInterface::evaluate.
+ */
+template<typename T>
+Result<bool> evaluateExpression(const Expression& expr,
+                                std::span<const std::span<const T>> inputs,
+                                std::span<T> result) {
+    Result<bool> r;
+    if(!checkExpressionArguments(expr, inputs, result, r))
+        return r;
+    const T* input_data[Expression::s_max_inputs];
+    for(size_t i = 0; i < inputs.size(); ++i) input_data[i] = inputs[i].data();
+    std::vector<T> registers(Expression::s_num_registers*Expression::s_block_size);
+    evaluateKernel(expr, input_data, result.data(), result.size(), registers.data());
+    return r;
+}
+
+}
+
+#endif
@@ -9,11 +9,142 @@
 #include <alpha/Exception.hpp>
 #include <alpha/Result.hpp>
 #include <thallium.hpp>
+#include <algorithm>
 #include <memory>
+#include <exception>
 #include <functional>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#if defined(__cpp_impl_coroutine)
+#include <coroutine>
+#endif
 
 namespace alpha {
 
+template<typename T, typename Wrapper>
+class Future;
+
+namespace detail {
+
+/**
+ * @brief Value or exception produced by a function, kept
+ * until it is retrieved with get().
+ */
+template<typename U>
+struct Outcome {
+    std::optional<U>   value;
+    std::exception_ptr error;
+
+    template<typename F>
+    void capture(F&& f) {
+        try {
+            value.emplace(std::forward<F>(f)());
+        } catch(...) {
+            error = std::current_exception();
+        }
+    }
+
+    U get() {
+        if(error) std::rethrow_exception(error);
+        return std::move(*value);
+    }
+};
+
+template<>
+struct Outcome<void> {
+    std::exception_ptr error;
+
+    template<typename F>
+    void capture(F&& f) {
+        try {
+            std::forward<F>(f)();
+        } catch(...) {
+            error = std::current_exception();
+        }
+    }
+
+    void get() {
+        if(error) std::rethrow_exception(error);
+    }
+};
+
+/**
+ * @brief Signals the completion of a continuation, both to the ULTs
+ * waiting for it and to the callbacks registered with onComplete.
+ */
+class Completion {
+
+    public:
+
+    /**
+     * @brief Mark the continuation as completed, waking up the ULTs
+     * waiting for it and calling the registered callbacks.
+     */
+    void complete() {
+        std::vector<std::function<void()>> callbacks;
+        {
+            std::unique_lock<thallium::mutex> lock{m_mutex};
+            m_completed = true;
+            callbacks.swap(m_callbacks);
+        }
+        m_ready.set_value();
+        for(auto& callback : callbacks) callback();
+    }
+
+    /**
+     * @brief Register a callback to be called by the ULT that completes
+     * the continuation. Returns false without registering it if the
+     * continuation has already completed.
+     */
+    bool onComplete(std::function<void()> callback) {
+        std::unique_lock<thallium::mutex> lock{m_mutex};
+        if(m_completed) return false;
+        m_callbacks.push_back(std::move(callback));
+        return true;
+    }
+
+    bool completed() {
+        return m_ready.test();
+    }
+
+    void wait() {
+        m_ready.wait();
+    }
+
+    private:
+
+    thallium::mutex                    m_mutex;
+    bool                               m_completed = false;
+    std::vector<std::function<void()>> m_callbacks;
+    thallium::eventual<void>           m_ready;
+};
+
+/**
+ * @brief Shared state between the ULT running a continuation
+ * and the Future returned by Future::then.
+ */
+template<typename U>
+struct ContinuationState : Completion, Outcome<U> {};
+
+template<typename T, typename F>
+struct ContinuationResult {
+    using type = std::invoke_result_t<F, T>;
+};
+
+template<typename F>
+struct ContinuationResult<void, F> {
+    using type = std::invoke_result_t<F>;
+};
+
+}
+
+template<typename T, typename Wrapper>
+size_t waitAny(std::span<Future<T, Wrapper>> futures);
+
 // TUTORIAL
 // ********
 //
@@ -29,6 +160,28 @@ namespace alpha {
 // necessarily the type returned by the RPC itself. The RPC is expected
 // to return a Result<Wrapper>, with Wrapper being a type that can be
 // implicitly converted into a T instance.
+//
+// A Future can also be built from a pair of functions, one to wait for
+// the result and one to test for completion. This is useful when the
+// operation is more than a single RPC, or when some resources (e.g. bulk
+// handles) must be kept alive until the operation completes.
+//
+// The free functions waitAll and waitAny can be used to wait on a set of
+// Futures, and Future::then attaches a continuation to a Future, which will
+// run in a ULT of a given pool without blocking the caller. thallium does not
+// offer completion callbacks on an async_response, so the continuation's ULT
+// is created right away and waits for the Future, suspended (using no CPU)
+// until the response arrives. When the Future is itself returned by then,
+// the continuation's ULT is only created once that Future has completed,
+// so a chain of continuations only has one ULT waiting at any time.
+//
+// When compiled with C++20 coroutine support, a Future can also be
+// co_await-ed from a coroutine (e.g. an alpha::Task, see Task.hpp). The
+// coroutine is suspended and a ULT created in the calling execution stream
+// waits for the Future, suspended until its response arrives (nothing polls
+// it), then resumes the coroutine. A coroutine awaiting a Future returned
+// by then is instead resumed by the ULT that completes the continuation.
+// See examples/coroutines.cpp.
 
 /**
  * @brief Future objects are used to keep track of
@@ -37,6 +190,9 @@ namespace alpha {
 template<typename T, typename Wrapper = T>
 class Future {
 
+    template<typename U, typename W>
+    friend size_t waitAny(std::span<Future<U, W>> futures);
+
     public:
 
     /**
@@ -50,9 +206,14 @@ class Future {
     Future(const Future& other) = default;
 
     /**
-     * @brief Move constructor.
+     * @brief Move constructor. The moved-from Future
+     * can no longer be waited on.
      */
-    Future(Future&& other) = default;
+    Future(Future&& other)
+    : m_resp(std::exchange(other.m_resp, std::nullopt))
+    , m_wait(std::exchange(other.m_wait, nullptr))
+    , m_test(std::exchange(other.m_test, nullptr))
+    , m_completion(std::exchange(other.m_completion, nullptr)) {}
 
     /**
      * @brief Copy-assignment operator.
@@ -62,7 +223,14 @@ class Future {
     /**
      * @brief Move-assignment operator.
      */
-    Future& operator=(Future&& other) = default;
+    Future& operator=(Future&& other) {
+        if(this == &other) return *this;
+        m_resp = std::exchange(other.m_resp, std::nullopt);
+        m_wait = std::exchange(other.m_wait, nullptr);
+        m_test = std::exchange(other.m_test, nullptr);
+        m_completion = std::exchange(other.m_completion, nullptr);
+        return *this;
+    }
 
     /**
      * @brief Destructor.
@@ -73,8 +241,10 @@ class Future {
      * @brief Wait for the request to complete.
      */
     T wait() {
+        if(m_wait) return m_wait();
+        if(!m_resp) throw Exception{"Cannot wait on an invalid Future"};
         try {
-            Result<Wrapper> result = m_resp.wait();
+            Result<Wrapper> result = m_resp->wait();
             if constexpr (!std::is_same_v<T, void>) {
                 return std::move(result).valueOrThrow();
             } else {
@@ -89,24 +259,240 @@ class Future {
      * @brief Test if the request has completed, without blocking.
      */
     bool completed() const {
+        if(m_test) return m_test();
+        if(!m_resp) throw Exception{"Cannot test an invalid Future"};
         try {
-            return m_resp.received();
+            return m_resp->received();
         } catch(const thallium::timeout&) {
             throw Exception{"Operation timed out"};
         }
     }
 
+    /**
+     * @brief Attaches a continuation to the Future. The callback will be
+     * called with the result of the Future (or without argument if T is
+     * void) in a ULT created in the specified pool, once the Future has
+     * completed. The Future is consumed by this call. If the Future was
+     * itself returned by then, the ULT is created when it completes,
+     * otherwise the ULT is created right away and waits for the Future.
+     *
+     * @param callback Function to call with the result.
+     * @param pool Pool in which to run the callback.
+     *
+     * @return a Future that can be awaited to get the value returned
+     * by the callback. If the original Future or the callback throw an
+     * exception, this exception is rethrown by this Future's wait().
+     */
+    template<typename F>
+    auto then(F&& callback, const thallium::pool& pool) && {
+        using U = typename detail::ContinuationResult<T, std::decay_t<F>>::type;
+        auto state  = std::make_shared<detail::ContinuationState<U>>();
+        auto source = std::make_shared<Future>(std::move(*this));
+        std::function<void()> run =
+            [state, source, callback=std::forward<F>(callback)]() mutable {
+                state->capture([&]() -> U {
+                    if constexpr (std::is_void_v<T>) {
+                        source->wait();
+                        return callback();
+                    } else {
+                        return callback(source->wait());
+                    }
+                });
+                state->complete();
+            };
+        thallium::pool target = pool;
+        auto completion = source->m_completion;
+        if(completion && completion->onComplete(
+            [target, run, state]() mutable {
+                try {
+                    target.make_thread(run, thallium::anonymous());
+                } catch(...) {
+                    state->error = std::current_exception();
+                    state->complete();
+                }
+            })) {
+            return Future<U, U>{state};
+        }
+        target.make_thread(run, thallium::anonymous());
+        return Future<U, U>{state};
+    }
+
+#if defined(__cpp_impl_coroutine)
+    /**
+     * @brief Awaiter returned by operator co_await. If the Future has
+     * not completed yet, the coroutine is suspended and resumed once the
+     * Future has completed, by a ULT created in the calling execution
+     * stream that waits for it (or by the ULT completing the continuation
+     * if the Future was returned by then). Because of this, co_await must
+     * be called from a ULT (or from a coroutine resumed by one).
+     */
+    class Awaiter {
+
+        public:
+
+        explicit Awaiter(Future& future)
+        : m_future(future) {}
+
+        bool await_ready() const {
+            return m_future.completed();
+        }
+
+        bool await_suspend(std::coroutine_handle<> handle) {
+            // the awaiter lives in the coroutine frame,
+            // which is not destroyed while it is suspended
+            if(m_future.m_completion)
+                return m_future.m_completion->onComplete([handle]() { handle.resume(); });
+            m_waited = true;
+            thallium::xstream::self().make_thread([this, handle]() {
+                m_outcome.capture([this]() -> T { return m_future.wait(); });
+                handle.resume();
+            }, thallium::anonymous());
+            return true;
+        }
+
+        T await_resume() {
+            if(m_waited) return m_outcome.get();
+            return m_future.wait();
+        }
+
+        private:
+
+        Future&            m_future;
+        bool               m_waited = false;
+        detail::Outcome<T> m_outcome;
+    };
+
+    /**
+     * @brief Makes the Future awaitable from a C++20 coroutine.
+     */
+    Awaiter operator co_await() {
+        return Awaiter{*this};
+    }
+#endif
+
     /**
      * @brief Constructor.
      */
     Future(thallium::async_response resp)
     : m_resp(std::move(resp)) {}
 
+    /**
+     * @brief Constructor from a function that waits for the result
+     * and a function that tests for completion without blocking.
+     */
+    Future(std::function<T()> wait_fn, std::function<bool()> test_fn)
+    : m_wait(std::move(wait_fn))
+    , m_test(std::move(test_fn)) {}
+
+    /**
+     * @brief Constructor from the state of a continuation (see then).
+     */
+    explicit Future(std::shared_ptr<detail::ContinuationState<T>> state)
+    : m_wait([state]() -> T { state->wait(); return state->get(); })
+    , m_test([state]() { return state->completed(); })
+    , m_completion(state) {}
+
     private:
 
-    thallium::async_response m_resp;
+    std::optional<thallium::async_response> m_resp;
+    std::function<T()>                      m_wait;
+    std::function<bool()>                   m_test;
+    std::shared_ptr<detail::Completion>     m_completion;
 };
 
+/**
+ * @brief Wait for all the Futures to complete. If any of them fails,
+ * the exception of the first one that failed is rethrown after all
+ * the Futures have completed.
+ *
+ * @return a vector with the results of the Futures (nothing if T is void).
+ */
+template<typename T, typename Wrapper>
+auto waitAll(std::span<Future<T, Wrapper>> futures) {
+    std::exception_ptr error;
+    if constexpr (std::is_void_v<T>) {
+        for(auto& future : futures) {
+            try {
+                future.wait();
+            } catch(...) {
+                if(!error) error = std::current_exception();
+            }
+        }
+        if(error) std::rethrow_exception(error);
+    } else {
+        std::vector<T> results;
+        results.reserve(futures.size());
+        for(auto& future : futures) {
+            try {
+                results.push_back(future.wait());
+            } catch(...) {
+                if(!error) error = std::current_exception();
+            }
+        }
+        if(error) std::rethrow_exception(error);
+        return results;
+    }
+}
+
+/**
+ * @brief Same as waitAll for a vector of Futures.
+ */
+template<typename T, typename Wrapper>
+auto waitAll(std::vector<Future<T, Wrapper>>& futures) {
+    return waitAll(std::span<Future<T, Wrapper>>{futures});
+}
+
+/**
+ * @brief Wait for any of the Futures to complete and return its index.
+ * The Future itself still needs to be awaited to get its result.
+ * If all the Futures directly wrap an RPC, this relies on thallium's
+ * async_response::wait_any, otherwise it polls the Futures, yielding
+ * to other ULTs between polls.
+ */
+template<typename T, typename Wrapper>
+size_t waitAny(std::span<Future<T, Wrapper>> futures) {
+    if(futures.empty())
+        throw Exception{"waitAny called on an empty set of futures"};
+    for(size_t i = 0; i < futures.size(); ++i)
+        if(futures[i].completed()) return i;
+    bool all_rpcs = std::all_of(futures.begin(), futures.end(),
+        [](const Future<T, Wrapper>& f) { return f.m_resp.has_value() && !f.m_wait; });
+    if(all_rpcs) {
+        std::vector<thallium::async_response> responses;
+        responses.reserve(futures.size());
+        for(auto& future : futures)
+            responses.push_back(std::move(*future.m_resp));
+        // the responses are given back to the Futures even if wait_any throws
+        auto restore = [&]() {
+            for(size_t i = 0; i < futures.size(); ++i)
+                futures[i].m_resp.emplace(std::move(responses[i]));
+        };
+        size_t index = 0;
+        try {
+            auto it = thallium::async_response::wait_any(responses.begin(), responses.end());
+            index = static_cast<size_t>(it - responses.begin());
+        } catch(...) {
+            restore();
+            throw;
+        }
+        restore();
+        return index;
+    }
+    while(true) {
+        for(size_t i = 0; i < futures.size(); ++i)
+            if(futures[i].completed()) return i;
+        thallium::thread::yield();
+    }
+}
+
+/**
+ * @brief Same as waitAny for a vector of Futures.
+ */
+template<typename T, typename Wrapper>
+size_t waitAny(std::vector<Future<T, Wrapper>>& futures) {
+    return waitAny(std::span<Future<T, Wrapper>>{futures});
+}
+
 }
 
 #endif
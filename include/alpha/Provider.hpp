@@ -8,6 +8,8 @@
 
 #include <thallium.hpp>
 #include <memory>
+#include <string>
+#include <unordered_map>
 
 namespace alpha {
 
@@ -49,6 +51,23 @@ class Provider {
              const std::string& config,
              const tl::pool& pool = tl::pool());
 
+    /**
+     * @brief Constructor taking additional named pools. The names of
+     * these pools can be used in the "rpc_pools" and "compute" fields of
+     * the configuration, in addition to the names of margo's pools.
+     *
+     * @param engine Thallium engine to use to receive RPCs.
+     * @param provider_id Provider id.
+     * @param config JSON-formatted configuration.
+     * @param pool Argobots pool to use to handle RPCs by default.
+     * @param named_pools Pools that can be referred to by name.
+     */
+    Provider(const tl::engine& engine,
+             uint16_t provider_id,
+             const std::string& config,
+             const tl::pool& pool,
+             const std::unordered_map<std::string, tl::pool>& named_pools);
+
     /**
      * @brief Copy-constructor is deleted.
      */
@@ -81,6 +100,23 @@ class Provider {
      */
     std::string getConfig() const;
 
+    /**
+     * @brief Return a JSON-formatted string containing runtime
+     * statistics of the provider (e.g. buffer pool hits and misses).
+     *
+     * @return JSON formatted string.
+     */
+    std::string getStats() const;
+
+    /**
+     * @brief Return the spans recorded by the provider if tracing
+     * is enabled in its configuration, in Chrome's JSON trace format
+     * (which can be loaded in chrome://tracing or ui.perfetto.dev).
+     *
+     * @return JSON formatted string.
+     */
+    std::string dumpTrace() const;
+
     /**
      * @brief Checks whether the Provider instance is valid.
      */
@@ -0,0 +1,203 @@
+/*
+ * (C) 2024 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#ifndef __ALPHA_REDUCTION_HPP
+#define __ALPHA_REDUCTION_HPP
+
+#include <alpha/DataType.hpp>
+#include <alpha/Result.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <type_traits>
+
+namespace alpha {
+
+// TUTORIAL
+// ********
+//
+// A reduction computes a single value (the sum, minimum, or maximum) over
+// an array x, or over the element-wise sums x+y of two arrays, without
+// materializing x+y. Reductions are accumulated in a wider type than the
+// elements (ReduceAccumulator): int64_t for integer arrays, double for
+// floating-point arrays. Integer sums wrap around on overflow.
+//
+// The provider splits large arrays into chunks, possibly processed by
+// several ULTs, and merges their partial results with combine().
+
+/**
+ * @brief Reduction operation.
+ */
+enum class ReduceOp : uint8_t {
+    Sum = 0,
+    Min = 1,
+    Max = 2
+};
+
+/**
+ * @brief Name of the ReduceOp (e.g. "sum").
+ */
+inline const char* toString(ReduceOp op) {
+    switch(op) {
+    case ReduceOp::Sum: return "sum";
+    case ReduceOp::Min: return "min";
+    case ReduceOp::Max: return "max";
+    }
+    return "invalid";
+}
+
+/**
+ * @brief Type in which reductions over arrays of T are accumulated.
+ */
+template<typename T>
+using ReduceAccumulator = std::conditional_t<std::is_integral_v<T>, int64_t, double>;
+
+/**
+ * @brief Value of a reduction over an empty array.
+ */
+template<typename Acc>
+constexpr Acc identity(ReduceOp op) {
+    switch(op) {
+    case ReduceOp::Min: return std::numeric_limits<Acc>::has_infinity
+                             ? std::numeric_limits<Acc>::infinity()
+                             : std::numeric_limits<Acc>::max();
+    case ReduceOp::Max: return std::numeric_limits<Acc>::has_infinity
+                             ? -std::numeric_limits<Acc>::infinity()
+                             : std::numeric_limits<Acc>::lowest();
+    default:            return Acc{0};
+    }
+}
+
+/**
+ * @brief Merge two partial results of a reduction.
+ */
+template<ReduceOp Op, typename Acc>
+constexpr Acc combine(Acc a, Acc b) {
+    if constexpr (Op == ReduceOp::Min) {
+        return std::min(a, b);
+    } else if constexpr (Op == ReduceOp::Max) {
+        return std::max(a, b);
+    } else if constexpr (std::is_integral_v<Acc>) {
+        using U = std::make_unsigned_t<Acc>;
+        return static_cast<Acc>(static_cast<U>(a) + static_cast<U>(b));
+    } else {
+        return a + b;
+    }
+}
+
+/**
+ * @brief Merge two partial results of a reduction.
+ */
+template<typename Acc>
+constexpr Acc combine(ReduceOp op, Acc a, Acc b) {
+    switch(op) {
+    case ReduceOp::Min: return combine<ReduceOp::Min>(a, b);
+    case ReduceOp::Max: return combine<ReduceOp::Max>(a, b);
+    default:            return combine<ReduceOp::Sum>(a, b);
+    }
+}
+
+namespace detail {
+
+/**
+ * @brief Reduction kernel for a given operation. The values are accumulated
+ * in s_lanes independent accumulators so that consecutive iterations do not
+ * depend on each other, which lets the compiler vectorize the loop (including
+ * floating-point sums, which it would not reorder otherwise). If HasY is
+ * false, only x is reduced and y is ignored.
+ */
+template<ReduceOp Op, bool HasY, typename T>
+[[gnu::always_inline]] inline ReduceAccumulator<T> reduceKernel(
+        const T* x, const T* y, size_t n) {
+    using Acc = ReduceAccumulator<T>;
+    constexpr size_t s_lanes = 16;
+    auto value = [x, y](size_t i) -> Acc {
+        if constexpr (!HasY) {
+            return static_cast<Acc>(x[i]);
+        } else if constexpr (std::is_same_v<T, int64_t>) {
+            // same wrap around as computeSums
+            return static_cast<Acc>(static_cast<uint64_t>(x[i]) + static_cast<uint64_t>(y[i]));
+        } else {
+            return static_cast<Acc>(x[i]) + static_cast<Acc>(y[i]);
+        }
+    };
+    Acc lanes[s_lanes];
+    std::fill(std::begin(lanes), std::end(lanes), identity<Acc>(Op));
+    size_t i = 0;
+    for(; i + s_lanes <= n; i += s_lanes)
+        for(size_t l = 0; l < s_lanes; ++l)
+            lanes[l] = combine<Op>(lanes[l], value(i + l));
+    for(; i < n; ++i)
+        lanes[0] = combine<Op>(lanes[0], value(i));
+    for(size_t l = 1; l < s_lanes; ++l)
+        lanes[0] = combine<Op>(lanes[0], lanes[l]);
+    return lanes[0];
+}
+
+template<ReduceOp Op, typename T>
+[[gnu::always_inline]] inline ReduceAccumulator<T> reduceKernel(
+        const T* x, const T* y, size_t n) {
+    return y ? reduceKernel<Op, true>(x, y, n) : reduceKernel<Op, false>(x, y, n);
+}
+
+}
+
+/**
+ * @brief Reduce the n values of x (or of x+y if y is not null). This function
+ * is always inlined, so that backends can call it from functions compiled for
+ * a specific instruction set (e.g. with __attribute__((target("avx2")))).
+ */
+template<typename T>
+[[gnu::always_inline]] inline ReduceAccumulator<T> reduceKernel(
+        ReduceOp op, const T* x, const T* y, size_t n) {
+    switch(op) {
+    case ReduceOp::Min: return detail::reduceKernel<ReduceOp::Min>(x, y, n);
+    case ReduceOp::Max: return detail::reduceKernel<ReduceOp::Max>(x, y, n);
+    default:            return detail::reduceKernel<ReduceOp::Sum>(x, y, n);
+    }
+}
+
+/**
+ * @brief Check the arguments of a reduction: the operation must be valid,
+ * y must be empty or have the same size as x, and the minimum and maximum
+ * are not defined for empty arrays. Returns false and sets the Result's
+ * error otherwise.
+ */
+template<typename R>
+bool checkReduceArguments(ReduceOp op, size_t x_size, size_t y_size, R& result) {
+    const char* error = nullptr;
+    if(op != ReduceOp::Sum && op != ReduceOp::Min && op != ReduceOp::Max)
+        error = "Invalid alpha::ReduceOp";
+    else if(y_size != 0 && y_size != x_size)
+        error = "reduce arguments must have the same size";
+    else if(x_size == 0 && op != ReduceOp::Sum)
+        error = "Cannot compute the min or max of an empty array";
+    if(!error) return true;
+    result.success() = false;
+    result.error() = error;
+    return false;
+}
+
+/**
+ * @brief Reduce x (or x+y if y is not empty) using the specified operation.
+ * This portable implementation is used by the default implementation of
+ * ResourceInterface::reduce.
+ */
+template<typename T>
+Result<ReduceAccumulator<T>> reduceArray(ReduceOp op,
+                                         std::span<const T> x,
+                                         std::span<const T> y) {
+    Result<ReduceAccumulator<T>> result;
+    if(!checkReduceArguments(op, x.size(), y.size(), result))
+        return result;
+    result.value() = reduceKernel(op, x.data(), y.empty() ? nullptr : y.data(), x.size());
+    return result;
+}
+
+}
+
+#endif
@@ -0,0 +1,110 @@
+/*
+ * (C) 2024 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#ifndef __ALPHA_REGISTERED_BUFFER_HPP
+#define __ALPHA_REGISTERED_BUFFER_HPP
+
+#include <alpha/BulkLocation.hpp>
+#include <alpha/Exception.hpp>
+#include <thallium.hpp>
+
+namespace alpha {
+
+class Client;
+
+// TUTORIAL
+// ********
+//
+// Exposing memory for RDMA (engine.expose) requires registering it with
+// the network card, which can be expensive. A RegisteredBuffer represents
+// a memory region that has been exposed once, and can be passed to many
+// operations (e.g. ResourceHandle::computeSums) without paying for the
+// registration again. RegisteredBuffer instances are created using
+// Client::registerBuffer, and the memory is deregistered when the last
+// copy of the RegisteredBuffer (or of a BulkLocation built from it) is
+// destroyed.
+
+/**
+ * @brief A RegisteredBuffer is a memory region that has been
+ * exposed for RDMA and can be reused across operations.
+ */
+class RegisteredBuffer {
+
+    friend class Client;
+
+    public:
+
+    /**
+     * @brief Constructor. The resulting RegisteredBuffer will be invalid.
+     */
+    RegisteredBuffer() = default;
+
+    /**
+     * @brief Pointer to the registered memory.
+     */
+    void* data() const {
+        return m_data;
+    }
+
+    /**
+     * @brief Size of the registered memory, in bytes.
+     */
+    size_t size() const {
+        return m_size;
+    }
+
+    /**
+     * @brief Access mode the memory was registered with.
+     */
+    thallium::bulk_mode mode() const {
+        return m_mode;
+    }
+
+    /**
+     * @brief Returns a BulkLocation covering the whole buffer.
+     */
+    BulkLocation location() const {
+        return location(0, m_size);
+    }
+
+    /**
+     * @brief Returns a BulkLocation covering a range of the buffer.
+     *
+     * @param offset Offset of the range, in bytes.
+     * @param size Size of the range, in bytes.
+     */
+    BulkLocation location(size_t offset, size_t size) const {
+        if(offset + size > m_size)
+            throw Exception{"Requested range exceeds the RegisteredBuffer's size"};
+        return BulkLocation{m_bulk, m_address, offset, size};
+    }
+
+    /**
+     * @brief Checks if the RegisteredBuffer instance is valid.
+     */
+    operator bool() const {
+        return m_data != nullptr;
+    }
+
+    private:
+
+    RegisteredBuffer(thallium::bulk bulk, std::string address,
+                     void* data, size_t size, thallium::bulk_mode mode)
+    : m_bulk(std::move(bulk))
+    , m_address(std::move(address))
+    , m_data(data)
+    , m_size(size)
+    , m_mode(mode) {}
+
+    thallium::bulk      m_bulk;
+    std::string         m_address;
+    void*               m_data = nullptr;
+    size_t              m_size = 0;
+    thallium::bulk_mode m_mode = thallium::bulk_mode::read_write;
+};
+
+}
+
+#endif
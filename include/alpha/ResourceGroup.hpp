@@ -0,0 +1,119 @@
+/*
+ * (C) 2024 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#ifndef __ALPHA_RESOURCE_GROUP_HPP
+#define __ALPHA_RESOURCE_GROUP_HPP
+
+#include <alpha/ResourceHandle.hpp>
+#include <alpha/RegisteredBuffer.hpp>
+#include <alpha/Future.hpp>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace alpha {
+
+// TUTORIAL
+// ********
+//
+// A ResourceGroup aggregates ResourceHandles pointing to resources that are
+// typically located in different providers (or different processes). Its
+// computeSums function splits the arrays into one contiguous slice per
+// resource and sends each slice to its resource with computeSumsFromBulk,
+// so that the resources pull, compute, and push their slices in parallel.
+// The client's memory is registered only once for all the slices.
+//
+// Each resource can be given a weight, in which case the size of its slice
+// is proportional to its weight. This is useful when the resources do not
+// run on identical nodes.
+
+/**
+ * @brief A ResourceGroup distributes operations across
+ * multiple resources.
+ */
+class ResourceGroup {
+
+    public:
+
+    /**
+     * @brief Constructor. The resulting ResourceGroup is empty.
+     */
+    ResourceGroup() = default;
+
+    /**
+     * @brief Constructor.
+     *
+     * @param handles ResourceHandles of the resources in the group.
+     * @param weights Weight of each resource (all resources get the
+     * same weight if empty).
+     */
+    ResourceGroup(std::vector<ResourceHandle> handles,
+                  std::vector<double> weights = {});
+
+    /**
+     * @brief Number of resources in the group.
+     */
+    size_t size() const {
+        return m_handles.size();
+    }
+
+    /**
+     * @brief Returns the ResourceHandle at the specified index.
+     */
+    const ResourceHandle& operator[](size_t index) const {
+        return m_handles[index];
+    }
+
+    /**
+     * @brief Checks if the ResourceGroup contains resources.
+     */
+    operator bool() const {
+        return !m_handles.empty();
+    }
+
+    /**
+     * @brief Computes the sums of two numbers in the x and y spans,
+     * distributing the work across the resources of the group.
+     * When the future completes, the results will be in the result span.
+     * The three spans must have the same size and remain valid until
+     * the future completes.
+     *
+     * @param x X values
+     * @param y Y values
+     * @param result Result values
+     *
+     * @return a Future<void> that completes when all the slices are done.
+     */
+    Future<void> computeSums(std::span<const int32_t> x, std::span<const int32_t> y,
+                             std::span<int32_t> result) const;
+
+    /**
+     * @brief Same as above with buffers that have already been registered
+     * using Client::registerBuffer.
+     *
+     * @param x X values
+     * @param y Y values
+     * @param result Result values
+     *
+     * @return a Future<void> that completes when all the slices are done.
+     */
+    Future<void> computeSums(const RegisteredBuffer& x, const RegisteredBuffer& y,
+                             const RegisteredBuffer& result) const;
+
+    /**
+     * @brief Returns the (offset, count) of the slice of an array of
+     * the specified number of elements assigned to each resource.
+     */
+    std::vector<std::pair<size_t, size_t>> slices(size_t count) const;
+
+    private:
+
+    std::vector<ResourceHandle> m_handles;
+    std::vector<double>         m_weights;
+};
+
+}
+
+#endif
@@ -10,11 +10,20 @@
 #include <memory>
 #include <chrono>
 #include <span>
+#include <string>
+#include <vector>
 #include <unordered_set>
 #include <alpha/Client.hpp>
 #include <alpha/Exception.hpp>
 #include <alpha/Future.hpp>
+#include <alpha/ResourceID.hpp>
 #include <alpha/BulkLocation.hpp>
+#include <alpha/DataType.hpp>
+#include <alpha/Reduction.hpp>
+#include <alpha/Scan.hpp>
+#include <alpha/Expression.hpp>
+#include <alpha/ArrayRef.hpp>
+#include <alpha/RegisteredBuffer.hpp>
 
 namespace alpha {
 
@@ -24,8 +33,11 @@ namespace alpha {
 // The ResourceHandle is the client-side object that represents a remote Resource.
 // Instances of this class can be created by the Client object. This ResourceHandle
 // class provides a few example functions that call RPCs on the target Resource:
-// computeSum, computeSumWithTimeout, computeSums, and computeSumsFromBulk.
-// See src/ResourceHandle.cpp for their implementation.
+// computeSum, computeSumWithTimeout, computeSums, computeSumsFromBulk, reduce, scan,
+// evaluate, and putArray/dropArray to manage arrays stored by the provider.
+// See src/ResourceHandle.cpp for their implementation. Since a provider can host
+// multiple resources, each ResourceHandle also holds the ResourceID of its target,
+// which is sent along with every RPC.
 
 class Client;
 class ResourceHandleImpl;
@@ -75,6 +87,10 @@ class ResourceHandle {
      */
     Client client() const;
 
+    /**
+     * @brief Returns the ID of the resource within its provider.
+     */
+    ResourceID resourceID() const;
 
     /**
      * @brief Checks if the ResourceHandle instance is valid.
@@ -94,6 +110,29 @@ class ResourceHandle {
      */
     Future<int32_t> computeSum(int32_t x, int32_t y) const;
 
+    /**
+     * @brief Enables batching of computeSum calls. While batching is enabled,
+     * computeSum calls are buffered and sent together in a single RPC when
+     * max_items calls have been buffered, when max_delay has elapsed since the
+     * first call was buffered, or when one of the returned futures is awaited.
+     * Batching is shared by all the copies of this ResourceHandle.
+     *
+     * @param max_items Maximum number of calls in a batch.
+     * @param max_delay Maximum time a call can stay buffered.
+     */
+    void enableBatching(size_t max_items, std::chrono::microseconds max_delay) const;
+
+    /**
+     * @brief Disables batching of computeSum calls, sending
+     * any call that is still buffered.
+     */
+    void disableBatching() const;
+
+    /**
+     * @brief Sends any computeSum call that is still buffered.
+     */
+    void flush() const;
+
     /**
      * @brief Same as computeSum but allows specifying a timeout after which
      * the operation is considered to have failed.
@@ -120,6 +159,42 @@ class ResourceHandle {
     Future<void> computeSums(std::span<const int32_t> x, std::span<const int32_t> y,
                              std::span<int32_t> result) const;
 
+    /**
+     * @brief Same as above for arrays of 64-bit integers.
+     */
+    Future<void> computeSums(std::span<const int64_t> x, std::span<const int64_t> y,
+                             std::span<int64_t> result) const;
+
+    /**
+     * @brief Same as above for arrays of floats.
+     */
+    Future<void> computeSums(std::span<const float> x, std::span<const float> y,
+                             std::span<float> result) const;
+
+    /**
+     * @brief Same as above for arrays of doubles.
+     */
+    Future<void> computeSums(std::span<const double> x, std::span<const double> y,
+                             std::span<double> result) const;
+
+    /**
+     * @brief Computes the sums of two numbers in the x and y buffers, which
+     * must have been registered using Client::registerBuffer. This avoids
+     * registering the memory for each call. When the future completes, the
+     * results will be in the result buffer. The three buffers must have the
+     * same size and remain valid until the future completes.
+     *
+     * @param x X values
+     * @param y Y values
+     * @param result Result values
+     * @param type Type of the elements
+     *
+     * @return a Future<void> that can be awaited.
+     */
+    Future<void> computeSums(const RegisteredBuffer& x, const RegisteredBuffer& y,
+                             const RegisteredBuffer& result,
+                             DataType type = DataType::Int32) const;
+
     /**
      * @brief Computes the sums of two numbers in the memory represented by
      * the BulkLocation instances. With this low-level function, one can
@@ -129,13 +204,230 @@ class ResourceHandle {
      * @param x Bulk location of the X values
      * @param y Bulk location of the Y values
      * @param result Bulk location of the result values
+     * @param type Type of the elements
      *
      * @return a Future<void> that can be awaited.
      */
     Future<void> computeSumsFromBulk(
         const BulkLocation& x,
         const BulkLocation& y,
-        const BulkLocation& result) const;
+        const BulkLocation& result,
+        DataType type = DataType::Int32) const;
+
+    /**
+     * @brief Computes the sums of the numbers in the x span and in the array
+     * stored by the provider that y refers to (see putArray). Only x is sent
+     * to the provider. The call fails if y refers to a version of the array
+     * that is no longer stored. The spans must have the same size as the
+     * stored array.
+     *
+     * @param x X values
+     * @param y Reference to the stored Y values
+     * @param result Result values
+     *
+     * @return a Future<void> that can be awaited.
+     */
+    Future<void> computeSums(std::span<const int32_t> x, const ArrayRef& y,
+                             std::span<int32_t> result) const;
+
+    /**
+     * @brief Same as above for arrays of 64-bit integers.
+     */
+    Future<void> computeSums(std::span<const int64_t> x, const ArrayRef& y,
+                             std::span<int64_t> result) const;
+
+    /**
+     * @brief Same as above for arrays of floats.
+     */
+    Future<void> computeSums(std::span<const float> x, const ArrayRef& y,
+                             std::span<float> result) const;
+
+    /**
+     * @brief Same as above for arrays of doubles.
+     */
+    Future<void> computeSums(std::span<const double> x, const ArrayRef& y,
+                             std::span<double> result) const;
+
+    /**
+     * @brief Uploads the data span into the memory of the provider, under the
+     * given name, so that later operations can refer to it with the returned
+     * ArrayRef instead of sending it again. Uploading an array under an existing
+     * name replaces it with a new version. The span must remain valid until the
+     * future completes.
+     *
+     * @param name Name of the array
+     * @param data Values of the array
+     *
+     * @return a Future<ArrayRef> that can be awaited to get the reference.
+     */
+    Future<ArrayRef> putArray(const std::string& name, std::span<const int32_t> data) const;
+
+    /**
+     * @brief Same as above for arrays of 64-bit integers.
+     */
+    Future<ArrayRef> putArray(const std::string& name, std::span<const int64_t> data) const;
+
+    /**
+     * @brief Same as above for arrays of floats.
+     */
+    Future<ArrayRef> putArray(const std::string& name, std::span<const float> data) const;
+
+    /**
+     * @brief Same as above for arrays of doubles.
+     */
+    Future<ArrayRef> putArray(const std::string& name, std::span<const double> data) const;
+
+    /**
+     * @brief Removes the array with the given name from the memory of the
+     * provider. Requests already using the array complete normally.
+     *
+     * @param name Name of the array
+     *
+     * @return a Future<void> that can be awaited.
+     */
+    Future<void> dropArray(const std::string& name) const;
+
+    /**
+     * @brief Reduces the x span (or the element-wise sums of the x and y
+     * spans, if y is not empty) into a single value computed by the provider,
+     * which only sends this value back. Integer arrays are reduced into an
+     * int64_t (sums wrap around on overflow), and floating-point arrays into
+     * a double. The spans must remain valid until the future completes.
+     *
+     * @param op Reduction operation (sum, min, or max)
+     * @param x X values
+     * @param y Y values (optional, same size as x)
+     *
+     * @return a Future<int64_t> that can be awaited to get the result.
+     */
+    Future<int64_t> reduce(ReduceOp op, std::span<const int32_t> x,
+                           std::span<const int32_t> y = {}) const;
+
+    /**
+     * @brief Same as above for arrays of 64-bit integers.
+     */
+    Future<int64_t> reduce(ReduceOp op, std::span<const int64_t> x,
+                           std::span<const int64_t> y = {}) const;
+
+    /**
+     * @brief Same as above for arrays of floats.
+     */
+    Future<double> reduce(ReduceOp op, std::span<const float> x,
+                          std::span<const float> y = {}) const;
+
+    /**
+     * @brief Same as above for arrays of doubles.
+     */
+    Future<double> reduce(ReduceOp op, std::span<const double> x,
+                          std::span<const double> y = {}) const;
+
+    /**
+     * @brief Computes the inclusive or exclusive scan (running totals) of the
+     * x span into the result span, which must have the same size. Integer
+     * scans wrap around on overflow. The provider scans the array in parallel
+     * and pushes the running totals back chunk by chunk. The spans must remain
+     * valid until the future completes.
+     *
+     * @param type Inclusive or exclusive scan
+     * @param x Input values
+     * @param result Running totals
+     *
+     * @return a Future<void> that can be awaited.
+     */
+    Future<void> scan(ScanType type, std::span<const int32_t> x,
+                      std::span<int32_t> result) const;
+
+    /**
+     * @brief Same as above for arrays of 64-bit integers.
+     */
+    Future<void> scan(ScanType type, std::span<const int64_t> x,
+                      std::span<int64_t> result) const;
+
+    /**
+     * @brief Same as above for arrays of floats.
+     */
+    Future<void> scan(ScanType type, std::span<const float> x,
+                      std::span<float> result) const;
+
+    /**
+     * @brief Same as above for arrays of doubles.
+     */
+    Future<void> scan(ScanType type, std::span<const double> x,
+                      std::span<double> result) const;
+
+    /**
+     * @brief Evaluates an element-wise Expression over the input spans
+     * (referenced in the expression by Expression::input(i)) in a single
+     * request, for instance 2.0*x + y - z. The provider reads each input and
+     * writes the result once, instead of once per operation as chained calls
+     * to computeSums would. The spans must have the same size and remain valid
+     * until the future completes, and result must not overlap the inputs.
+     *
+     * @param expr Expression to evaluate
+     * @param inputs Input values
+     * @param result Result values
+     *
+     * @return a Future<void> that can be awaited.
+     */
+    Future<void> evaluate(const Expression& expr,
+                          const std::vector<std::span<const int32_t>>& inputs,
+                          std::span<int32_t> result) const;
+
+    /**
+     * @brief Same as above for arrays of 64-bit integers.
+     */
+    Future<void> evaluate(const Expression& expr,
+                          const std::vector<std::span<const int64_t>>& inputs,
+                          std::span<int64_t> result) const;
+
+    /**
+     * @brief Same as above for arrays of floats.
+     */
+    Future<void> evaluate(const Expression& expr,
+                          const std::vector<std::span<const float>>& inputs,
+                          std::span<float> result) const;
+
+    /**
+     * @brief Same as above for arrays of doubles.
+     */
+    Future<void> evaluate(const Expression& expr,
+                          const std::vector<std::span<const double>>& inputs,
+                          std::span<double> result) const;
+
+    /**
+     * @brief Evaluates an element-wise Expression over the memory represented
+     * by the BulkLocation instances, which may belong to different processes.
+     *
+     * @param expr Expression to evaluate
+     * @param inputs Bulk locations of the input values
+     * @param result Bulk location of the result values
+     * @param type Type of the elements
+     *
+     * @return a Future<void> that can be awaited.
+     */
+    Future<void> evaluateFromBulk(
+        const Expression& expr,
+        const std::vector<BulkLocation>& inputs,
+        const BulkLocation& result,
+        DataType type = DataType::Int32) const;
+
+    /**
+     * @brief Requests the performance counters of the provider
+     * managing the target resource (RPC counts and latencies, bytes
+     * moved, requests in flight, etc.).
+     *
+     * @return a Future<std::string> that can be awaited to get the
+     * JSON-formatted statistics.
+     */
+    Future<std::string> getStats() const;
+
+    /**
+     * @brief Destroys the target resource. Requests already received
+     * by the provider complete normally, subsequent requests fail.
+     *
+     * @return a Future<void> that can be awaited.
+     */
+    Future<void> destroy() const;
 
     private:
 
@@ -147,6 +439,47 @@ class ResourceHandle {
      */
     ResourceHandle(const std::shared_ptr<ResourceHandleImpl>& impl);
 
+    /**
+     * @brief Implementation of computeSums for spans of any DataType.
+     */
+    template<typename T>
+    Future<void> computeSumsImpl(std::span<const T> x, std::span<const T> y,
+                                 std::span<T> result) const;
+
+    /**
+     * @brief Implementation of computeSums with a stored array for spans of any DataType.
+     */
+    template<typename T>
+    Future<void> computeSumsWithArrayImpl(std::span<const T> x, const ArrayRef& y,
+                                          std::span<T> result) const;
+
+    /**
+     * @brief Implementation of putArray for spans of any DataType.
+     */
+    template<typename T>
+    Future<ArrayRef> putArrayImpl(const std::string& name, std::span<const T> data) const;
+
+    /**
+     * @brief Implementation of reduce for spans of any DataType.
+     */
+    template<typename T>
+    Future<ReduceAccumulator<T>> reduceImpl(ReduceOp op, std::span<const T> x,
+                                            std::span<const T> y) const;
+
+    /**
+     * @brief Implementation of scan for spans of any DataType.
+     */
+    template<typename T>
+    Future<void> scanImpl(ScanType type, std::span<const T> x, std::span<T> result) const;
+
+    /**
+     * @brief Implementation of evaluate for spans of any DataType.
+     */
+    template<typename T>
+    Future<void> evaluateImpl(const Expression& expr,
+                              const std::vector<std::span<const T>>& inputs,
+                              std::span<T> result) const;
+
     std::shared_ptr<ResourceHandleImpl> self;
 };
 
@@ -0,0 +1,82 @@
+/*
+ * (C) 2024 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#ifndef __ALPHA_RESOURCE_ID_HPP
+#define __ALPHA_RESOURCE_ID_HPP
+
+#include <compare>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace alpha {
+
+// TUTORIAL
+// ********
+//
+// A provider can host many resources. Each of them is identified by a
+// ResourceID, which is sent as the first argument of every RPC targeting
+// the resource. The ResourceID is a 32-bit integer wrapped in its own type
+// so that it cannot be mistaken for a provider id or any other integer.
+// The resource configured in the "resource" field of the provider's
+// configuration has ResourceID 0.
+
+/**
+ * @brief Identifier of a resource within a provider.
+ */
+class ResourceID {
+
+    public:
+
+    /**
+     * @brief Constructor. The default ResourceID is 0.
+     */
+    constexpr ResourceID() = default;
+
+    /**
+     * @brief Constructor from an integer value.
+     */
+    constexpr explicit ResourceID(uint32_t value)
+    : m_value(value) {}
+
+    /**
+     * @brief Integer value of the ResourceID.
+     */
+    constexpr uint32_t value() const {
+        return m_value;
+    }
+
+    /**
+     * @brief String representation of the ResourceID.
+     */
+    std::string toString() const {
+        return std::to_string(m_value);
+    }
+
+    constexpr auto operator<=>(const ResourceID&) const = default;
+
+    /**
+     * @brief Serialization function for Thallium.
+     */
+    template<typename Archive>
+    void serialize(Archive& ar) {
+        ar(m_value);
+    }
+
+    private:
+
+    uint32_t m_value = 0;
+};
+
+}
+
+template<>
+struct std::hash<alpha::ResourceID> {
+    size_t operator()(const alpha::ResourceID& id) const {
+        return std::hash<uint32_t>{}(id.value());
+    }
+};
+
+#endif
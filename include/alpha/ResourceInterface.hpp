@@ -7,9 +7,14 @@
 #define __ALPHA_RESOURCE_INTERFACE_HPP
 
 #include <alpha/Result.hpp>
+#include <alpha/DataType.hpp>
+#include <alpha/Reduction.hpp>
+#include <alpha/Scan.hpp>
+#include <alpha/Expression.hpp>
 #include <unordered_set>
 #include <unordered_map>
 #include <functional>
+#include <span>
 #include <nlohmann/json.hpp>
 #include <thallium.hpp>
 
@@ -23,7 +28,19 @@
 // In the follow example, while the ResourceHandle has 4 versions
 // of a computeSum* functionality (to handle timeouts, vectors, bulk handles,
 // etc.) this turns into 2 different RPCs that the provider can receive,
-// which turn into 1 call to the Resource's computeSum method.
+// which turn into calls to the Resource's computeSum and computeSums methods.
+// computeSums has a default implementation that falls back to computeSum,
+// so a backend only needs to override it if it can process arrays faster.
+// computeSums also has overloads for the other DataTypes (int64, float, and
+// double arrays), which by default report that the type is not supported.
+// The reduce methods compute a single value (sum, min, or max) from one array,
+// or from the element-wise sums of two arrays. They have a portable default
+// implementation (see Reduction.hpp), which backends can override with faster
+// kernels. Likewise, the scan methods compute the running totals of an array
+// (see Scan.hpp), starting from a carry provided by the provider, which splits
+// large arrays into blocks scanned in parallel. Finally, the evaluate methods
+// compute an element-wise Expression over several arrays in a single pass
+// (see Expression.hpp).
 //
 // In general, it would be common for the provider to handle things like
 // bulk transfers before and after calls to the Resource's API.
@@ -107,6 +124,218 @@ class ResourceInterface {
      */
     virtual Result<int32_t> computeSum(int32_t x, int32_t y) = 0;
 
+    /**
+     * @brief Compute the element-wise sums of two arrays of integers.
+     * The default implementation calls computeSum on each pair of elements.
+     * Backends should override it with a batched implementation.
+     *
+     * @param x first array
+     * @param y second array
+     * @param result array in which to place the sums
+     *
+     * @return a Result indicating whether the operation succeeded.
+     */
+    virtual Result<bool> computeSums(std::span<const int32_t> x,
+                                     std::span<const int32_t> y,
+                                     std::span<int32_t> result) {
+        Result<bool> r;
+        if(x.size() != y.size() || x.size() != result.size()) {
+            r.success() = false;
+            r.error() = "computeSums arguments must have the same size";
+            return r;
+        }
+        for(size_t i = 0; i < x.size(); ++i) {
+            auto s = computeSum(x[i], y[i]);
+            if(!s.success()) {
+                r.success() = false;
+                r.error() = std::move(s.error());
+                return r;
+            }
+            result[i] = s.value();
+        }
+        return r;
+    }
+
+    /**
+     * @brief Compute the element-wise sums of two arrays of 64-bit integers.
+     * The default implementation reports that the type is not supported.
+     */
+    virtual Result<bool> computeSums(std::span<const int64_t>,
+                                     std::span<const int64_t>,
+                                     std::span<int64_t>) {
+        return unsupported<int64_t>();
+    }
+
+    /**
+     * @brief Compute the element-wise sums of two arrays of floats.
+     * The default implementation reports that the type is not supported.
+     */
+    virtual Result<bool> computeSums(std::span<const float>,
+                                     std::span<const float>,
+                                     std::span<float>) {
+        return unsupported<float>();
+    }
+
+    /**
+     * @brief Compute the element-wise sums of two arrays of doubles.
+     * The default implementation reports that the type is not supported.
+     */
+    virtual Result<bool> computeSums(std::span<const double>,
+                                     std::span<const double>,
+                                     std::span<double>) {
+        return unsupported<double>();
+    }
+
+    /**
+     * @brief Reduce an array of integers (or the element-wise sums of
+     * two arrays, if y is not empty) into a single value. The default
+     * implementation uses the portable kernel from Reduction.hpp.
+     *
+     * @param op reduction operation
+     * @param x first array
+     * @param y second array (may be empty)
+     *
+     * @return a Result containing the reduced value.
+     */
+    virtual Result<int64_t> reduce(ReduceOp op,
+                                   std::span<const int32_t> x,
+                                   std::span<const int32_t> y) {
+        return reduceArray(op, x, y);
+    }
+
+    /**
+     * @brief Same as above for arrays of 64-bit integers.
+     */
+    virtual Result<int64_t> reduce(ReduceOp op,
+                                   std::span<const int64_t> x,
+                                   std::span<const int64_t> y) {
+        return reduceArray(op, x, y);
+    }
+
+    /**
+     * @brief Same as above for arrays of floats.
+     */
+    virtual Result<double> reduce(ReduceOp op,
+                                  std::span<const float> x,
+                                  std::span<const float> y) {
+        return reduceArray(op, x, y);
+    }
+
+    /**
+     * @brief Same as above for arrays of doubles.
+     */
+    virtual Result<double> reduce(ReduceOp op,
+                                  std::span<const double> x,
+                                  std::span<const double> y) {
+        return reduceArray(op, x, y);
+    }
+
+    /**
+     * @brief Compute the inclusive or exclusive scan (running totals) of an
+     * array of integers, starting from the specified carry. The result span
+     * may be the same memory as x. The default implementation uses the
+     * portable kernel from Scan.hpp.
+     *
+     * @param type inclusive or exclusive scan
+     * @param x input array
+     * @param result array in which to place the running totals
+     * @param carry value to which the running totals are added
+     *
+     * @return a Result indicating whether the operation succeeded.
+     */
+    virtual Result<bool> scan(ScanType type,
+                              std::span<const int32_t> x,
+                              std::span<int32_t> result,
+                              int32_t carry) {
+        return scanArray(type, x, result, carry);
+    }
+
+    /**
+     * @brief Same as above for arrays of 64-bit integers.
+     */
+    virtual Result<bool> scan(ScanType type,
+                              std::span<const int64_t> x,
+                              std::span<int64_t> result,
+                              int64_t carry) {
+        return scanArray(type, x, result, carry);
+    }
+
+    /**
+     * @brief Same as above for arrays of floats.
+     */
+    virtual Result<bool> scan(ScanType type,
+                              std::span<const float> x,
+                              std::span<float> result,
+                              float carry) {
+        return scanArray(type, x, result, carry);
+    }
+
+    /**
+     * @brief Same as above for arrays of doubles.
+     */
+    virtual Result<bool> scan(ScanType type,
+                              std::span<const double> x,
+                              std::span<double> result,
+                              double carry) {
+        return scanArray(type, x, result, carry);
+    }
+
+    /**
+     * @brief Evaluate an element-wise Expression over input arrays of
+     * integers, writing the values into result. The inputs must have the
+     * same size as result. The default implementation uses the portable
+     * block interpreter from Expression.hpp.
+     *
+     * @param expr expression to evaluate
+     * @param inputs input arrays, referenced by Expression::input(i)
+     * @param result array in which to place the values
+     *
+     * @return a Result indicating whether the operation succeeded.
+     */
+    virtual Result<bool> evaluate(const Expression& expr,
+                                  std::span<const std::span<const int32_t>> inputs,
+                                  std::span<int32_t> result) {
+        return evaluateExpression(expr, inputs, result);
+    }
+
+    /**
+     * @brief Same as above for arrays of 64-bit integers.
+     */
+    virtual Result<bool> evaluate(const Expression& expr,
+                                  std::span<const std::span<const int64_t>> inputs,
+                                  std::span<int64_t> result) {
+        return evaluateExpression(expr, inputs, result);
+    }
+
+    /**
+     * @brief Same as above for arrays of floats.
+     */
+    virtual Result<bool> evaluate(const Expression& expr,
+                                  std::span<const std::span<const float>> inputs,
+                                  std::span<float> result) {
+        return evaluateExpression(expr, inputs, result);
+    }
+
+    /**
+     * @brief Same as above for arrays of doubles.
+     */
+    virtual Result<bool> evaluate(const Expression& expr,
+                                  std::span<const std::span<const double>> inputs,
+                                  std::span<double> result) {
+        return evaluateExpression(expr, inputs, result);
+    }
+
+    private:
+
+    template<typename T>
+    Result<bool> unsupported() const {
+        Result<bool> r;
+        r.success() = false;
+        r.error() = std::string{"computeSums on "} + toString(dataTypeOf<T>)
+                  + " arrays is not supported by backend " + m_name;
+        return r;
+    }
+
 };
 
 /**
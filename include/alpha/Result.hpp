@@ -6,9 +6,11 @@
 #ifndef __ALPHA_RESULT_HPP
 #define __ALPHA_RESULT_HPP
 
+#include <cereal/cereal.hpp>
 #include <cereal/types/string.hpp>
-#include <cereal/types/variant.hpp>
 #include <alpha/Exception.hpp>
+#include <cstdint>
+#include <memory>
 #include <string>
 
 namespace alpha {
@@ -20,20 +22,113 @@ namespace alpha {
 // It acts like a variant with a main type T and an alpha::Exception for
 // error handling. RPCs will generally either pass their return value as T
 // or propagate an exception to be thrown by the client.
+//
+// A Result is created for every response. It only holds its flags and its
+// value, the error string being allocated when an error is set, and it is
+// serialized as a single tag byte (0 for success, 1 for an error, 2 for a
+// retryable error) followed by either the value or the error string.
+// The serialized size and the cost of serializing a successful Result are
+// the same as with a bool followed by the value (see benchmarks/result-benchmark.cpp),
+// what is saved is the size of the object and the string it no longer holds.
+
+namespace detail {
+
+/**
+ * @brief Status of a Result: success and retryable flags,
+ * and an error string allocated only when it is accessed.
+ */
+class ResultStatus {
+
+    public:
+
+    enum Tag : uint8_t { Success = 0, Error = 1, RetryableError = 2 };
+
+    ResultStatus() = default;
+
+    ResultStatus(ResultStatus&&) = default;
+
+    ResultStatus& operator=(ResultStatus&&) = default;
+
+    ResultStatus(const ResultStatus& other)
+    : m_success(other.m_success)
+    , m_retryable(other.m_retryable)
+    , m_error(other.m_error ? std::make_unique<std::string>(*other.m_error) : nullptr) {}
+
+    ResultStatus& operator=(const ResultStatus& other) {
+        if(this == &other) return *this;
+        m_success   = other.m_success;
+        m_retryable = other.m_retryable;
+        m_error     = other.m_error ? std::make_unique<std::string>(*other.m_error) : nullptr;
+        return *this;
+    }
+
+    bool& success() {
+        return m_success;
+    }
+
+    const bool& success() const {
+        return m_success;
+    }
+
+    bool& retryable() {
+        return m_retryable;
+    }
+
+    const bool& retryable() const {
+        return m_retryable;
+    }
+
+    std::string& error() {
+        if(!m_error) m_error = std::make_unique<std::string>();
+        return *m_error;
+    }
+
+    const std::string& error() const {
+        static const std::string s_empty;
+        return m_error ? *m_error : s_empty;
+    }
+
+    void check() const {
+        if(!m_success)
+            throw Exception(error());
+    }
+
+    template<typename Archive>
+    void saveTag(Archive& a) const {
+        uint8_t tag = m_success ? Success : m_retryable ? RetryableError : Error;
+        a(tag);
+        if(!m_success) a(error());
+    }
+
+    template<typename Archive>
+    void loadTag(Archive& a) {
+        uint8_t tag = Success;
+        a(tag);
+        m_success   = tag == Success;
+        m_retryable = tag == RetryableError;
+        if(!m_success) a(error());
+        else m_error.reset();
+    }
+
+    private:
+
+    bool                         m_success   = true;
+    bool                         m_retryable = false;
+    std::unique_ptr<std::string> m_error;
+};
+
+}
 
 /**
  * @brief The Result object is a generic object
  * used to hold and send back the result of an RPC.
- * It contains three fields:
+ * It contains four fields:
  * - success must be set to true if the request succeeded, false otherwise
+ * - retryable may be set to true if the request failed but can be retried
  * - error must be set to an error string if an error occured
  * - value must be set to the result of the request if it succeeded
  *
- * This class is specialized for two types: bool and std::string.
- * If bool is used, both the value and the success fields will be
- * managed by the same underlying variable. If std::string is used,
- * both the value and the error fields will be managed by the same
- * underlying variable.
+ * This class is specialized for void, in which case it has no value.
  *
  * @tparam T Type of the result.
  */
@@ -49,31 +144,27 @@ class Result {
 
     template<typename U>
     Result(Result<U>&& other)
-    : m_success{other.m_success}
-    , m_error{std::move(other.m_error)}
+    : m_status{std::move(other.m_status)}
     , m_value{std::move(other.m_value)} {}
 
     template<typename U>
     Result(const Result<U>& other)
-    : m_success{other.m_success}
-    , m_error{other.m_error}
+    : m_status{other.m_status}
     , m_value{other.m_value} {}
 
     template<typename U>
     Result& operator=(Result<U>&& other) {
         if(this == reinterpret_cast<decltype(this)>(&other)) return *this;
-        m_success = other.m_success;
-        m_error   = std::move(other.m_error);
-        m_value   = std::move(other.m_value);
+        m_status = std::move(other.m_status);
+        m_value  = std::move(other.m_value);
         return *this;
     }
 
     template<typename U>
     Result& operator=(const Result<U>& other) {
         if(this == reinterpret_cast<decltype(this)>(&other)) return *this;
-        m_success = other.m_success;
-        m_error   = other.m_error;
-        m_value   = other.m_value;
+        m_status = other.m_status;
+        m_value  = other.m_value;
         return *this;
     }
 
@@ -81,28 +172,44 @@ class Result {
      * @brief Whether the request succeeded.
      */
     bool& success() {
-        return m_success;
+        return m_status.success();
     }
 
     /**
      * @brief Whether the request succeeded.
      */
     const bool& success() const {
-        return m_success;
+        return m_status.success();
+    }
+
+    /**
+     * @brief Whether the request failed because of a transient condition
+     * (e.g. the server is overloaded), in which case it can be retried.
+     */
+    bool& retryable() {
+        return m_status.retryable();
+    }
+
+    /**
+     * @brief Whether the request failed because of a transient condition
+     * (e.g. the server is overloaded), in which case it can be retried.
+     */
+    const bool& retryable() const {
+        return m_status.retryable();
     }
 
     /**
      * @brief Error string if the request failed.
      */
     std::string& error() {
-        return m_error;
+        return m_status.error();
     }
 
     /**
      * @brief Error string if the request failed.
      */
     const std::string& error() const {
-        return m_error;
+        return m_status.error();
     }
 
     /**
@@ -162,8 +269,7 @@ class Result {
      * contains an error.
      */
     void check() const {
-        if(!m_success)
-            throw Exception(m_error);
+        m_status.check();
     }
 
     /**
@@ -173,20 +279,29 @@ class Result {
      * @param a Archive instance.
      */
     template<typename Archive>
-    void serialize(Archive& a) {
-        a & m_success;
-        if(m_success) {
-            a & m_value;
-        } else {
-            a & m_error;
-        }
+    void save(Archive& a) const {
+        m_status.saveTag(a);
+        if(!m_status.success()) return;
+        a(m_value);
+    }
+
+    /**
+     * @brief Deserialization function for Thallium.
+     *
+     * @tparam Archive Archive type.
+     * @param a Archive instance.
+     */
+    template<typename Archive>
+    void load(Archive& a) {
+        m_status.loadTag(a);
+        if(!m_status.success()) return;
+        a(m_value);
     }
 
     private:
 
-    bool        m_success = true;
-    std::string m_error   = "";
-    T           m_value;
+    detail::ResultStatus m_status;
+    T                    m_value{};
 };
 
 template<>
@@ -201,27 +316,23 @@ class Result<void> {
 
     template<typename U>
     Result(Result<U>&& other)
-    : m_success{other.m_success}
-    , m_error{std::move(other.m_error)} {}
+    : m_status{std::move(other.m_status)} {}
 
     template<typename U>
     Result(const Result<U>& other)
-    : m_success{other.m_success}
-    , m_error{other.m_error} {}
+    : m_status{other.m_status} {}
 
     template<typename U>
     Result& operator=(Result<U>&& other) {
         if(this == reinterpret_cast<decltype(this)>(&other)) return *this;
-        m_success = other.m_success;
-        m_error   = std::move(other.m_error);
+        m_status = std::move(other.m_status);
         return *this;
     }
 
     template<typename U>
     Result& operator=(const Result<U>& other) {
         if(this == reinterpret_cast<decltype(this)>(&other)) return *this;
-        m_success = other.m_success;
-        m_error   = other.m_error;
+        m_status = other.m_status;
         return *this;
     }
 
@@ -229,28 +340,44 @@ class Result<void> {
      * @brief Whether the request succeeded.
      */
     bool& success() {
-        return m_success;
+        return m_status.success();
     }
 
     /**
      * @brief Whether the request succeeded.
      */
     const bool& success() const {
-        return m_success;
+        return m_status.success();
+    }
+
+    /**
+     * @brief Whether the request failed because of a transient condition
+     * (e.g. the server is overloaded), in which case it can be retried.
+     */
+    bool& retryable() {
+        return m_status.retryable();
+    }
+
+    /**
+     * @brief Whether the request failed because of a transient condition
+     * (e.g. the server is overloaded), in which case it can be retried.
+     */
+    const bool& retryable() const {
+        return m_status.retryable();
     }
 
     /**
      * @brief Error string if the request failed.
      */
     std::string& error() {
-        return m_error;
+        return m_status.error();
     }
 
     /**
      * @brief Error string if the request failed.
      */
     const std::string& error() const {
-        return m_error;
+        return m_status.error();
     }
 
     /**
@@ -280,8 +407,7 @@ class Result<void> {
      * contains an error.
      */
     void check() const {
-        if(!m_success)
-            throw Exception(m_error);
+        m_status.check();
     }
 
     /**
@@ -291,17 +417,24 @@ class Result<void> {
      * @param a Archive instance.
      */
     template<typename Archive>
-    void serialize(Archive& a) {
-        a & m_success;
-        if(!m_success) {
-            a & m_error;
-        }
+    void save(Archive& a) const {
+        m_status.saveTag(a);
+    }
+
+    /**
+     * @brief Deserialization function for Thallium.
+     *
+     * @tparam Archive Archive type.
+     * @param a Archive instance.
+     */
+    template<typename Archive>
+    void load(Archive& a) {
+        m_status.loadTag(a);
     }
 
     private:
 
-    bool        m_success = true;
-    std::string m_error   = "";
+    detail::ResultStatus m_status;
 };
 
 }
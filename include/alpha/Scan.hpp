@@ -0,0 +1,121 @@
+/*
+ * (C) 2024 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#ifndef __ALPHA_SCAN_HPP
+#define __ALPHA_SCAN_HPP
+
+#include <alpha/DataType.hpp>
+#include <alpha/Result.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+
+namespace alpha {
+
+// TUTORIAL
+// ********
+//
+// A scan (or prefix sum) computes the running totals of an array. An inclusive
+// scan sets result[i] to x[0] + ... + x[i], an exclusive scan sets it to
+// x[0] + ... + x[i-1] (hence result[0] is 0). Integer scans wrap around on
+// overflow, like computeSums.
+//
+// Scans of large arrays are split into blocks processed in parallel: the total
+// of each block is computed first (with a reduction), the totals of the blocks
+// preceding each block are added up into its carry, then each block is scanned
+// starting from its carry. Resources therefore scan arrays starting from a
+// given carry, and floating-point scans may differ from a sequential scan by
+// rounding errors.
+
+/**
+ * @brief Type of scan.
+ */
+enum class ScanType : uint8_t {
+    Inclusive = 0,
+    Exclusive = 1
+};
+
+/**
+ * @brief Name of the ScanType (e.g. "inclusive").
+ */
+inline const char* toString(ScanType type) {
+    switch(type) {
+    case ScanType::Inclusive: return "inclusive";
+    case ScanType::Exclusive: return "exclusive";
+    }
+    return "invalid";
+}
+
+/**
+ * @brief Addition used by scans, wrapping around on overflow for integers.
+ */
+template<typename T>
+constexpr T scanAdd(T a, T b) {
+    if constexpr (std::is_integral_v<T>) {
+        using U = std::make_unsigned_t<T>;
+        return static_cast<T>(static_cast<U>(a) + static_cast<U>(b));
+    } else {
+        return a + b;
+    }
+}
+
+/**
+ * @brief Scan the n values of x into r, starting from the specified carry,
+ * and return the carry for the next values (i.e. carry + x[0] + ... + x[n-1]).
+ * r may be equal to x.
+ */
+template<typename T>
+[[gnu::always_inline]] inline T scanKernel(ScanType type, const T* x, T* r, size_t n, T carry) {
+    if(type == ScanType::Exclusive) {
+        for(size_t i = 0; i < n; ++i) {
+            auto value = x[i];
+            r[i] = carry;
+            carry = scanAdd(carry, value);
+        }
+    } else {
+        for(size_t i = 0; i < n; ++i) {
+            carry = scanAdd(carry, x[i]);
+            r[i] = carry;
+        }
+    }
+    return carry;
+}
+
+/**
+ * @brief Check the arguments of a scan: the type must be valid and
+ * result must have the same size as x. Returns false and sets the
+ * Result's error otherwise.
+ */
+template<typename R>
+bool checkScanArguments(ScanType type, size_t x_size, size_t result_size, R& result) {
+    const char* error = nullptr;
+    if(type != ScanType::Inclusive && type != ScanType::Exclusive)
+        error = "Invalid alpha::ScanType";
+    else if(x_size != result_size)
+        error = "scan arguments must have the same size";
+    if(!error) return true;
+    result.success() = false;
+    result.error() = error;
+    return false;
+}
+
+/**
+ * @brief Scan x into result (which may be the same memory as x) starting
+ * from the specified carry. This portable implementation is used by the
+ * default implementation of ResourceInterface::scan.
+ */
+template<typename T>
+Result<bool> scanArray(ScanType type, std::span<const T> x, std::span<T> result, T carry) {
+    Result<bool> r;
+    if(!checkScanArguments(type, x.size(), result.size(), r))
+        return r;
+    scanKernel(type, x.data(), result.data(), x.size(), carry);
+    return r;
+}
+
+}
+
+#endif
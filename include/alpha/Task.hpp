@@ -0,0 +1,34 @@
+/*
+ * (C) 2024 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#ifndef __ALPHA_TASK_HPP
+#define __ALPHA_TASK_HPP
+
+#if defined(__cpp_impl_coroutine)
+#include <coroutine>
+#include <exception>
+
+namespace alpha {
+
+/**
+ * @brief Minimal fire-and-forget coroutine type, from which Futures can
+ * be co_await-ed (see Future.hpp). The coroutine starts eagerly and its
+ * frame is destroyed when it finishes. Exceptions must not escape it.
+ */
+struct Task {
+    struct promise_type {
+        Task get_return_object() { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+
+}
+
+#endif
+
+#endif
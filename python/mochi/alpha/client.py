@@ -3,3 +3,7 @@ import _pyalpha_client
 
 Client = _pyalpha_client.Client
 ResourceHandle = _pyalpha_client.ResourceHandle
+ReduceOp = _pyalpha_client.ReduceOp
+ScanType = _pyalpha_client.ScanType
+Expression = _pyalpha_client.Expression
+ArrayRef = _pyalpha_client.ArrayRef
@@ -1,5 +1,5 @@
 import unittest
-from mochi.alpha.client import Client, ResourceHandle
+from mochi.alpha.client import Client, ResourceHandle, ReduceOp, ScanType, Expression
 from mochi.alpha.server import Provider
 import pymargo
 from pymargo.core import Engine
@@ -32,6 +32,15 @@ class TestResourceHandle(unittest.TestCase):
         future = handle.compute_sum(34, 56)
         self.assertEqual(future.wait(), 90)
 
+    def test_compute_sum_batched(self):
+        handle = self.client.make_resource_handle(address=str(self.engine.address),
+                                                  provider_id=42)
+        handle.enable_batching(max_items=4, max_delay_us=1000)
+        futures = [handle.compute_sum(i, 2*i) for i in range(10)]
+        for i, future in enumerate(futures):
+            self.assertEqual(future.wait(), 3*i)
+        handle.disable_batching()
+
     def test_compute_sum_with_timeout(self):
         handle = self.client.make_resource_handle(address=str(self.engine.address),
                                                   provider_id=42)
@@ -49,3 +58,95 @@ class TestResourceHandle(unittest.TestCase):
         self.assertIsNone(future.wait())
         for i in range(0, 3):
             self.assertEqual(r[i], x[i] + y[i])
+
+    def test_compute_sum_typed_arrays(self):
+        handle = self.client.make_resource_handle(address=str(self.engine.address),
+                                                  provider_id=42)
+        import array
+        for typecode in ['q', 'f', 'd']:
+            x = array.array(typecode, [1, 2, 3])
+            y = array.array(typecode, [4, 5, 6])
+            r = array.array(typecode, [0, 0, 0])
+            handle.compute_sums(x, y, r).wait()
+            self.assertEqual(list(r), [5, 7, 9])
+        with self.assertRaises(Exception):
+            handle.compute_sums(array.array('d', [1]), array.array('f', [1]),
+                                array.array('d', [0]))
+
+    def test_reduce(self):
+        handle = self.client.make_resource_handle(address=str(self.engine.address),
+                                                  provider_id=42)
+        import array
+        x = array.array('i', [3, -1, 7])
+        y = array.array('i', [1, 1, 1])
+        self.assertEqual(handle.reduce(ReduceOp.SUM, x).wait(), 9)
+        self.assertEqual(handle.reduce(ReduceOp.MIN, x).wait(), -1)
+        self.assertEqual(handle.reduce(ReduceOp.MAX, x, y).wait(), 8)
+        self.assertEqual(handle.reduce(ReduceOp.SUM, array.array('d', [0.5, 0.25])).wait(), 0.75)
+        with self.assertRaises(Exception):
+            handle.reduce(ReduceOp.MIN, array.array('i'))
+
+    def test_scan(self):
+        handle = self.client.make_resource_handle(address=str(self.engine.address),
+                                                  provider_id=42)
+        import array
+        x = array.array('i', [3, -1, 7, 2])
+        r = array.array('i', [0, 0, 0, 0])
+        handle.scan(ScanType.INCLUSIVE, x, r).wait()
+        self.assertEqual(list(r), [3, 2, 9, 11])
+        handle.scan(ScanType.EXCLUSIVE, x, r).wait()
+        self.assertEqual(list(r), [0, 3, 2, 9])
+
+    def test_evaluate(self):
+        handle = self.client.make_resource_handle(address=str(self.engine.address),
+                                                  provider_id=42)
+        import array
+        x, y, z = Expression.input(0), Expression.input(1), Expression.input(2)
+        a = array.array('i', [3, -1, 7])
+        b = array.array('i', [1, 2, 3])
+        c = array.array('i', [5, 5, 5])
+        r = array.array('i', [0, 0, 0])
+        handle.evaluate(2*x + y - z, [a, b, c], r).wait()
+        self.assertEqual(list(r), [2, -5, 12])
+        d = array.array('d', [1.0, 2.0])
+        rd = array.array('d', [0.0, 0.0])
+        handle.evaluate(Expression.max(-x, x / 4), [d], rd).wait()
+        self.assertEqual(list(rd), [0.25, 0.5])
+        with self.assertRaises(Exception):
+            handle.evaluate(x / y, [a, b], r)
+
+    def test_stored_arrays(self):
+        handle = self.client.make_resource_handle(address=str(self.engine.address),
+                                                  provider_id=42)
+        import array
+        x = array.array('i', [1, 2, 3])
+        y = array.array('i', [10, 20, 30])
+        r = array.array('i', [0, 0, 0])
+        y_ref = handle.put_array("y", y).wait()
+        self.assertEqual(y_ref.name, "y")
+        handle.compute_sums(x, y_ref, r).wait()
+        self.assertEqual(list(r), [11, 22, 33])
+        handle.drop_array("y").wait()
+        with self.assertRaises(Exception):
+            handle.compute_sums(x, y_ref, r).wait()
+
+    def test_get_stats(self):
+        import json
+        handle = self.client.make_resource_handle(address=str(self.engine.address),
+                                                  provider_id=42)
+        handle.compute_sum(1, 2).wait()
+        stats = json.loads(handle.get_stats().wait())
+        self.assertEqual(stats["rpcs"]["alpha_compute_sum"]["calls"], 1)
+        stats = self.provider.get_stats()
+        self.assertIn("alpha_get_stats", stats["rpcs"])
+
+    def test_multiple_resources(self):
+        address = str(self.engine.address)
+        handle = self.client.create_resource(address=address, provider_id=42, type="dummy")
+        self.assertNotEqual(handle.resource_id, 0)
+        other = self.client.make_resource_handle(address=address, provider_id=42,
+                                                 resource_id=handle.resource_id, check=True)
+        self.assertEqual(other.compute_sum(1, 2).wait(), 3)
+        handle.destroy().wait()
+        with self.assertRaises(Exception):
+            other.compute_sum(1, 2).wait()
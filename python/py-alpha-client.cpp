@@ -2,6 +2,10 @@
 #include <alpha/Client.hpp>
 #include <alpha/ResourceHandle.hpp>
 #include <pybind11/pybind11.h>
+#include <pybind11/operators.h>
+#include <pybind11/stl.h>
+#include <optional>
+#include <vector>
 
 namespace py = pybind11;
 using namespace pybind11::literals;
@@ -26,12 +30,81 @@ static void exportFutureType(const char* name, py::module_ m) {
              "Blocks until the future has completed, then returns the result.");
 }
 
+/**
+ * @brief Return the DataType of the elements of a contiguous
+ * one-dimensional buffer, throwing if it is not supported.
+ */
+static alpha::DataType bufferDataType(const py::buffer_info& info) {
+    if(info.ndim != 1) throw alpha::Exception{"Invalid array dimenion (should be 1)"};
+    if(info.strides[0] != info.itemsize)
+        throw alpha::Exception{"Array should be contiguous"};
+    auto format = info.format;
+    if(!format.empty() && std::string{"@=<"}.find(format[0]) != std::string::npos)
+        format = format.substr(1);
+    if(format.size() == 1 && std::string{"ilq"}.find(format[0]) != std::string::npos) {
+        if(info.itemsize == sizeof(int32_t)) return alpha::DataType::Int32;
+        if(info.itemsize == sizeof(int64_t)) return alpha::DataType::Int64;
+    }
+    if(format == "f" && info.itemsize == sizeof(float))  return alpha::DataType::Float32;
+    if(format == "d" && info.itemsize == sizeof(double)) return alpha::DataType::Float64;
+    throw alpha::Exception{"Invalid array content type (should be int32, int64, float32, or float64)"};
+}
+
 
 PYBIND11_MODULE(_pyalpha_client, m) {
     m.doc() = "Python binding for the Alpha client library";
 
     py::register_exception<alpha::Exception>(m, "Exception");
 
+    py::enum_<alpha::ReduceOp>(m, "ReduceOp")
+        .value("SUM", alpha::ReduceOp::Sum)
+        .value("MIN", alpha::ReduceOp::Min)
+        .value("MAX", alpha::ReduceOp::Max);
+
+    py::enum_<alpha::ScanType>(m, "ScanType")
+        .value("INCLUSIVE", alpha::ScanType::Inclusive)
+        .value("EXCLUSIVE", alpha::ScanType::Exclusive);
+
+    py::class_<alpha::Expression>(m, "Expression",
+            R"(
+            Element-wise expression over input arrays, built from
+            Expression.input(i), constants, and the +, -, *, / operators,
+            e.g. 2*Expression.input(0) + Expression.input(1).
+            )")
+        .def(py::init<double>(), "value"_a)
+        .def_static("input", &alpha::Expression::input, "index"_a,
+            "Expression representing the input array at the given index.")
+        .def_static("constant", &alpha::Expression::constant, "value"_a,
+            "Expression representing a constant.")
+        .def_static("min", &alpha::Expression::min, "a"_a, "b"_a,
+            "Element-wise minimum of two expressions.")
+        .def_static("max", &alpha::Expression::max, "a"_a, "b"_a,
+            "Element-wise maximum of two expressions.")
+        .def(py::self + py::self)
+        .def(py::self - py::self)
+        .def(py::self * py::self)
+        .def(py::self / py::self)
+        .def(py::self + double())
+        .def(py::self - double())
+        .def(py::self * double())
+        .def(py::self / double())
+        .def(double() + py::self)
+        .def(double() - py::self)
+        .def(double() * py::self)
+        .def(double() / py::self)
+        .def(-py::self);
+    py::implicitly_convertible<double, alpha::Expression>();
+
+    py::class_<alpha::ArrayRef>(m, "ArrayRef",
+            R"(
+            Reference to an array stored by a provider (see
+            ResourceHandle.put_array). A version of 0 refers to
+            the current version of the array.
+            )")
+        .def_readonly("name", &alpha::ArrayRef::name)
+        .def_readwrite("version", &alpha::ArrayRef::version)
+        .def_readonly("size", &alpha::ArrayRef::size);
+
     py::class_<alpha::Client>(m, "Client")
         .def(py::init([](const py::object& pyMargoEngine) {
             py::capsule mid = pyMargoEngine.attr("get_internal_mid")();
@@ -52,8 +125,11 @@ PYBIND11_MODULE(_pyalpha_client, m) {
             )",
             "engine"_a)
         .def("make_resource_handle",
-            py::overload_cast<const std::string&, uint16_t, bool>(
-                 &alpha::Client::makeResourceHandle, py::const_),
+            [](const alpha::Client& client, const std::string& address,
+               uint16_t provider_id, bool check, uint32_t resource_id) {
+                return client.makeResourceHandle(
+                    address, provider_id, alpha::ResourceID{resource_id}, check);
+            },
             R"(
             Create a ResourceHandle.
 
@@ -62,17 +138,43 @@ PYBIND11_MODULE(_pyalpha_client, m) {
 
             address (str): Address of the process owning the resource.
             provider_id (int): Provider ID of the resource.
-            check (Optional[bool]): Check that the provider exists.
+            check (Optional[bool]): Check that the provider and the resource exist.
+            resource_id (Optional[int]): ID of the resource within the provider.
+
+            Returns
+            -------
+
+            A alpha.ResourceHandle instance.
+            )",
+            "address"_a, "provider_id"_a, "check"_a=false, "resource_id"_a=0)
+        .def("create_resource", &alpha::Client::createResource,
+            R"(
+            Create a resource in a provider and return a handle to it.
+
+            Parameters
+            ----------
+
+            address (str): Address of the process owning the provider.
+            provider_id (int): Provider ID.
+            type (str): Type of resource.
+            config (Optional[str]): JSON-formatted configuration of the resource.
 
             Returns
             -------
 
             A alpha.ResourceHandle instance.
             )",
-            "address"_a, "provider_id"_a, "check"_a=false)
+            "address"_a, "provider_id"_a, "type"_a, "config"_a="{}")
         ;
 
     py::class_<alpha::ResourceHandle>(m, "ResourceHandle")
+        .def_property_readonly("resource_id",
+                [](const alpha::ResourceHandle& handle) {
+                    return handle.resourceID().value();
+                },
+            "ID of the resource within its provider.")
+        .def("destroy", &alpha::ResourceHandle::destroy,
+             "Destroy the resource. Returns a Future object to wait on.")
         .def("compute_sum", &alpha::ResourceHandle::computeSum,
             R"(
             "Compute the sum of two numbers.
@@ -88,6 +190,23 @@ PYBIND11_MODULE(_pyalpha_client, m) {
 
             A Future object that the caller must wait on to get the result.
             )", "x"_a, "y"_a)
+        .def("enable_batching",
+                [](const alpha::ResourceHandle& handle, size_t max_items, int max_delay_us) {
+                    handle.enableBatching(max_items, std::chrono::microseconds{max_delay_us});
+                },
+            R"(
+            Enable batching of compute_sum calls.
+
+            Parameters
+            ----------
+
+            max_items (int): Maximum number of calls sent in a batch.
+            max_delay_us (int): Maximum time (in microseconds) a call can be buffered.
+            )", "max_items"_a, "max_delay_us"_a)
+        .def("disable_batching", &alpha::ResourceHandle::disableBatching,
+             "Disable batching of compute_sum calls, sending buffered calls.")
+        .def("flush", &alpha::ResourceHandle::flush,
+             "Send buffered compute_sum calls.")
         .def("compute_sum_with_timeout",
                 [](const alpha::ResourceHandle& handle, int32_t x, int32_t y, int timeout_ms) {
                     return handle.computeSumWithTimeout(x, y, std::chrono::milliseconds{timeout_ms});
@@ -112,23 +231,22 @@ PYBIND11_MODULE(_pyalpha_client, m) {
                    const py::buffer& x, const py::buffer& y,
                    const py::buffer& r) {
 
-                    auto check_array_valid = [](const py::buffer& buf) {
-                        auto info = buf.request();
-                        if(info.ndim != 1) throw alpha::Exception{"Invalid array dimenion (should be 1)"};
-                        if(info.itemsize != sizeof(int32_t)) throw alpha::Exception{"Invalid itemsize"};
-                        if(info.format != py::format_descriptor<int32_t>::format())
-                            throw alpha::Exception{"Invalid array content type"};
-                        return info;
-                    };
-
-                    py::buffer_info x_info = check_array_valid(x);
-                    py::buffer_info y_info = check_array_valid(y);
-                    py::buffer_info r_info = check_array_valid(r);
-
-                    return handle.computeSums(
-                        std::span((const int32_t*)x_info.ptr, x_info.size),
-                        std::span((const int32_t*)y_info.ptr, y_info.size),
-                        std::span((int32_t*)r_info.ptr, r_info.size));
+                    // buffers are passed to computeSums without copy, dispatching
+                    // on their element type (int32, int64, float32, or float64)
+                    py::buffer_info x_info = x.request();
+                    py::buffer_info y_info = y.request();
+                    py::buffer_info r_info = r.request(true);
+                    auto type = bufferDataType(x_info);
+                    if(bufferDataType(y_info) != type || bufferDataType(r_info) != type)
+                        throw alpha::Exception{"Arrays should have the same content type"};
+
+                    return alpha::visitDataType(type, [&](auto t) {
+                        using T = typename decltype(t)::type;
+                        return handle.computeSums(
+                            std::span((const T*)x_info.ptr, x_info.size),
+                            std::span((const T*)y_info.ptr, y_info.size),
+                            std::span((T*)r_info.ptr, r_info.size));
+                    });
                 },
             R"(
             "Compute the sum of numbers in two arrays.
@@ -136,16 +254,208 @@ PYBIND11_MODULE(_pyalpha_client, m) {
             Parameters
             ----------
 
-            x (array[int]): First array of numbers.
-            y (array[int]): Second array of number.
-            r (array[int]): Wrray in which to place the results.
+            x (array): First array of numbers.
+            y (array): Second array of number.
+            r (array): Array in which to place the results.
+
+            The three arrays must be contiguous and contain elements
+            of the same type: int32, int64, float32, or float64.
+
+            Returns
+            -------
+
+            A Future object that the caller must wait on.
+            )", "x"_a, "y"_a, "r"_a)
+        .def("compute_sums",
+                [](const alpha::ResourceHandle& handle, const py::buffer& x,
+                   const alpha::ArrayRef& y, const py::buffer& r) {
+                    py::buffer_info x_info = x.request();
+                    py::buffer_info r_info = r.request(true);
+                    auto type = bufferDataType(x_info);
+                    if(bufferDataType(r_info) != type)
+                        throw alpha::Exception{"Arrays should have the same content type"};
+                    return alpha::visitDataType(type, [&](auto t) {
+                        using T = typename decltype(t)::type;
+                        return handle.computeSums(
+                            std::span((const T*)x_info.ptr, x_info.size), y,
+                            std::span((T*)r_info.ptr, r_info.size));
+                    });
+                },
+            R"(
+            Compute the sum of numbers in an array and in an array
+            stored by the provider.
+
+            Parameters
+            ----------
+
+            x (array): First array of numbers.
+            y (ArrayRef): Reference to the stored array of numbers.
+            r (array): Array in which to place the results.
+
+            Returns
+            -------
+
+            A Future object that the caller must wait on.
+            )", "x"_a, "y"_a, "r"_a)
+        .def("put_array",
+                [](const alpha::ResourceHandle& handle, const std::string& name,
+                   const py::buffer& data) {
+                    py::buffer_info info = data.request();
+                    return alpha::visitDataType(bufferDataType(info), [&](auto t) {
+                        using T = typename decltype(t)::type;
+                        return handle.putArray(name, std::span((const T*)info.ptr, info.size));
+                    });
+                },
+            R"(
+            Upload an array into the memory of the provider under
+            the given name, replacing any previous version.
+
+            Parameters
+            ----------
+
+            name (str): Name of the array.
+            data (array): Contiguous array of int32, int64, float32, or float64.
+
+            Returns
+            -------
+
+            A Future object that the caller must wait on to get the ArrayRef.
+            )", "name"_a, "data"_a)
+        .def("drop_array", &alpha::ResourceHandle::dropArray,
+            R"(
+            Remove the array with the given name from the memory of the provider.
+
+            Returns
+            -------
+
+            A Future object that the caller must wait on.
+            )", "name"_a)
+        .def("reduce",
+                [](const alpha::ResourceHandle& handle, alpha::ReduceOp op,
+                   const py::buffer& x, const std::optional<py::buffer>& y) {
+                    py::buffer_info x_info = x.request();
+                    py::buffer_info y_info;
+                    auto type = bufferDataType(x_info);
+                    if(y) {
+                        y_info = y->request();
+                        if(bufferDataType(y_info) != type)
+                            throw alpha::Exception{"Arrays should have the same content type"};
+                    }
+                    return alpha::visitDataType(type, [&](auto t) -> py::object {
+                        using T = typename decltype(t)::type;
+                        return py::cast(handle.reduce(
+                            op, std::span((const T*)x_info.ptr, x_info.size),
+                            y ? std::span((const T*)y_info.ptr, y_info.size)
+                              : std::span<const T>{}));
+                    });
+                },
+            R"(
+            Reduce an array (or the element-wise sums of two arrays) into a
+            single value computed by the provider.
+
+            Parameters
+            ----------
+
+            op (ReduceOp): Reduction operation (SUM, MIN, or MAX).
+            x (array): First array of numbers.
+            y (array): Optional second array of numbers.
+
+            The arrays must be contiguous and contain elements of the same
+            type: int32, int64, float32, or float64.
+
+            Returns
+            -------
+
+            A Future object that the caller must wait on to get the result
+            (an int for integer arrays, a float for floating-point arrays).
+            )", "op"_a, "x"_a, "y"_a = py::none())
+        .def("scan",
+                [](const alpha::ResourceHandle& handle, alpha::ScanType type,
+                   const py::buffer& x, const py::buffer& r) {
+                    py::buffer_info x_info = x.request();
+                    py::buffer_info r_info = r.request(true);
+                    auto data_type = bufferDataType(x_info);
+                    if(bufferDataType(r_info) != data_type)
+                        throw alpha::Exception{"Arrays should have the same content type"};
+                    return alpha::visitDataType(data_type, [&](auto t) {
+                        using T = typename decltype(t)::type;
+                        return handle.scan(
+                            type, std::span((const T*)x_info.ptr, x_info.size),
+                            std::span((T*)r_info.ptr, r_info.size));
+                    });
+                },
+            R"(
+            Compute the running totals (prefix sums) of an array.
+
+            Parameters
+            ----------
+
+            type (ScanType): INCLUSIVE or EXCLUSIVE scan.
+            x (array): Array of numbers.
+            r (array): Array in which to place the running totals.
+
+            The arrays must be contiguous and contain elements of the same
+            type: int32, int64, float32, or float64.
+
+            Returns
+            -------
+
+            A Future object that the caller must wait on.
+            )", "type"_a, "x"_a, "r"_a)
+        .def("evaluate",
+                [](const alpha::ResourceHandle& handle, const alpha::Expression& expr,
+                   const std::vector<py::buffer>& inputs, const py::buffer& r) {
+                    py::buffer_info r_info = r.request(true);
+                    auto type = bufferDataType(r_info);
+                    std::vector<py::buffer_info> input_infos;
+                    for(auto& input : inputs) {
+                        input_infos.push_back(input.request());
+                        if(bufferDataType(input_infos.back()) != type)
+                            throw alpha::Exception{"Arrays should have the same content type"};
+                    }
+                    return alpha::visitDataType(type, [&](auto t) {
+                        using T = typename decltype(t)::type;
+                        std::vector<std::span<const T>> input_spans;
+                        for(auto& info : input_infos)
+                            input_spans.emplace_back((const T*)info.ptr, info.size);
+                        return handle.evaluate(expr, input_spans,
+                                               std::span((T*)r_info.ptr, r_info.size));
+                    });
+                },
+            R"(
+            Evaluate an element-wise expression over input arrays in a
+            single request.
+
+            Parameters
+            ----------
+
+            expr (Expression): Expression to evaluate.
+            inputs (list): Input arrays, referenced by Expression.input(i).
+            r (array): Array in which to place the results.
+
+            The arrays must be contiguous and contain elements of the same
+            type: int32, int64, float32, or float64.
 
             Returns
             -------
 
             A Future object that the caller must wait on.
-            )", "x"_a, "y"_a, "r"_a);
+            )", "expr"_a, "inputs"_a, "r"_a)
+        .def("get_stats", &alpha::ResourceHandle::getStats,
+            R"(
+            Get the performance counters of the provider managing the resource.
+
+            Returns
+            -------
+
+            A Future object that the caller must wait on to get
+            the JSON-formatted statistics.
+            )");
 
     exportFutureType<int32_t>("Int32", m);
+    exportFutureType<int64_t>("Int64", m);
+    exportFutureType<double>("Float64", m);
     exportFutureType<void>("Void", m);
+    exportFutureType<std::string>("String", m);
+    exportFutureType<alpha::ArrayRef>("ArrayRef", m);
 }
@@ -43,5 +43,20 @@ PYBIND11_MODULE(_pyalpha_server, m) {
             "provider_id"_a,
             "config"_a,
             py::keep_alive<1, 2>())
+        .def("get_stats",
+            [](const alpha::Provider& provider) {
+                py::module json = py::module::import("json");
+                return json.attr("loads")(provider.getStats());
+            },
+            R"(
+            Get the performance counters of the provider.
+
+            Returns
+            -------
+
+            A dict with RPC counts and latency histograms, bytes moved
+            with RDMA, requests in flight, and buffer pool and endpoint
+            cache statistics.
+            )")
         ;
 }
@@ -0,0 +1,183 @@
+/*
+ * (C) 2024 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#ifndef __ALPHA_ADMISSION_CONTROL_H
+#define __ALPHA_ADMISSION_CONTROL_H
+
+#include <thallium.hpp>
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+
+namespace alpha {
+
+namespace tl = thallium;
+
+/**
+ * @brief The AdmissionControl bounds the number of bytes of server memory
+ * used by requests in flight. Requests acquire a Ticket for the bytes they
+ * need before allocating anything, and the bytes are released when the
+ * Ticket is destroyed.
+ *
+ * When the budget is exhausted, requests either wait in a FIFO queue
+ * (policy "queue") or are rejected immediately (policy "reject"), in which
+ * case the client is expected to retry later. A request needing more than
+ * the whole budget is admitted alone. A budget of 0 disables admission
+ * control.
+ */
+class AdmissionControl {
+
+    using json = nlohmann::json;
+
+    public:
+
+    enum class Policy { Queue, Reject };
+
+    /**
+     * @brief RAII object releasing the acquired bytes when destroyed.
+     */
+    class Ticket {
+
+        friend class AdmissionControl;
+
+        AdmissionControl* m_owner = nullptr;
+        size_t            m_bytes = 0;
+
+        Ticket(AdmissionControl* owner, size_t bytes)
+        : m_owner(owner)
+        , m_bytes(bytes) {}
+
+        public:
+
+        Ticket() = default;
+
+        Ticket(Ticket&& other)
+        : m_owner(std::exchange(other.m_owner, nullptr))
+        , m_bytes(other.m_bytes) {}
+
+        Ticket& operator=(Ticket&& other) {
+            if(this == &other) return *this;
+            release();
+            m_owner = std::exchange(other.m_owner, nullptr);
+            m_bytes = other.m_bytes;
+            return *this;
+        }
+
+        Ticket(const Ticket&) = delete;
+
+        Ticket& operator=(const Ticket&) = delete;
+
+        ~Ticket() {
+            release();
+        }
+
+        void release() {
+            if(m_owner) m_owner->release(m_bytes);
+            m_owner = nullptr;
+        }
+    };
+
+    /**
+     * @brief Constructor.
+     *
+     * @param max_bytes Maximum number of bytes in flight (0 for unlimited).
+     * @param policy What to do with requests that exceed the budget.
+     */
+    AdmissionControl(size_t max_bytes, Policy policy)
+    : m_max_bytes(max_bytes)
+    , m_policy(policy) {}
+
+    AdmissionControl(const AdmissionControl&) = delete;
+
+    AdmissionControl& operator=(const AdmissionControl&) = delete;
+
+    /**
+     * @brief Acquire the specified number of bytes, waiting for them to
+     * be available if the policy is Queue. Returns an empty optional if
+     * the request is rejected.
+     */
+    std::optional<Ticket> acquire(size_t bytes) {
+        if(m_max_bytes == 0) return Ticket{};
+        bytes = std::min(bytes, m_max_bytes);
+        std::unique_lock<tl::mutex> lock{m_mutex};
+        // requests are admitted in arrival order: a request that fits
+        // does not overtake requests already waiting in the queue
+        if(m_queue.empty() && m_in_flight + bytes <= m_max_bytes) {
+            m_in_flight += bytes;
+            m_admitted += 1;
+            return Ticket{this, bytes};
+        }
+        if(m_policy == Policy::Reject) {
+            m_rejected += 1;
+            return std::nullopt;
+        }
+        auto ticket_number = m_next_ticket++;
+        m_queue.push_back(ticket_number);
+        m_queued += 1;
+        m_cv.wait(lock, [&]() {
+            return m_queue.front() == ticket_number && m_in_flight + bytes <= m_max_bytes;
+        });
+        m_queue.pop_front();
+        m_in_flight += bytes;
+        m_admitted += 1;
+        // the next request in the queue may fit as well
+        if(!m_queue.empty()) m_cv.notify_all();
+        return Ticket{this, bytes};
+    }
+
+    /**
+     * @brief Return the admission control's configuration.
+     */
+    json getConfig() const {
+        return json{
+            {"max_inflight_bytes", m_max_bytes},
+            {"policy", m_policy == Policy::Queue ? "queue" : "reject"}
+        };
+    }
+
+    /**
+     * @brief Return the number of bytes in flight, the number of
+     * waiting requests, and admitted/queued/rejected counters.
+     */
+    json getStats() const {
+        std::unique_lock<tl::mutex> lock{m_mutex};
+        return json{
+            {"inflight_bytes", m_in_flight},
+            {"waiting", m_queue.size()},
+            {"admitted", m_admitted},
+            {"queued", m_queued},
+            {"rejected", m_rejected}
+        };
+    }
+
+    private:
+
+    void release(size_t bytes) {
+        std::unique_lock<tl::mutex> lock{m_mutex};
+        m_in_flight -= bytes;
+        if(!m_queue.empty()) m_cv.notify_all();
+    }
+
+    size_t                 m_max_bytes;
+    Policy                 m_policy;
+    mutable tl::mutex      m_mutex;
+    tl::condition_variable m_cv;
+    std::deque<uint64_t>   m_queue;
+    uint64_t               m_next_ticket = 0;
+    size_t                 m_in_flight   = 0;
+    size_t                 m_admitted    = 0;
+    size_t                 m_queued      = 0;
+    size_t                 m_rejected    = 0;
+};
+
+}
+
+#endif
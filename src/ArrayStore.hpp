@@ -0,0 +1,190 @@
+/*
+ * (C) 2024 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#ifndef __ALPHA_ARRAY_STORE_H
+#define __ALPHA_ARRAY_STORE_H
+
+#include "alpha/ArrayRef.hpp"
+#include "alpha/ResourceID.hpp"
+
+#include <thallium.hpp>
+#include <nlohmann/json.hpp>
+
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace alpha {
+
+namespace tl = thallium;
+
+/**
+ * @brief The ArrayStore keeps the arrays uploaded by clients (see
+ * ResourceHandle::putArray), indexed by resource and name. When the
+ * stored arrays exceed max_bytes or max_arrays, the least recently
+ * used ones are evicted. Arrays are shared with the requests using
+ * them, so evicting or dropping an array never invalidates memory
+ * that a request is still reading.
+ */
+class ArrayStore {
+
+    using json = nlohmann::json;
+
+    public:
+
+    /**
+     * @brief Array stored by the ArrayStore.
+     */
+    struct Array {
+        ArrayRef          ref;
+        std::vector<char> data;
+    };
+
+    /**
+     * @brief Constructor.
+     *
+     * @param max_bytes Maximum total size of the stored arrays.
+     * @param max_arrays Maximum number of stored arrays.
+     */
+    ArrayStore(size_t max_bytes, size_t max_arrays)
+    : m_max_bytes(max_bytes)
+    , m_max_arrays(max_arrays) {}
+
+    ArrayStore(const ArrayStore&) = delete;
+
+    ArrayStore& operator=(const ArrayStore&) = delete;
+
+    /**
+     * @brief Check whether an array of the given size can be stored.
+     */
+    bool fits(size_t size) const {
+        return size <= m_max_bytes && m_max_arrays != 0;
+    }
+
+    /**
+     * @brief Store the array under its name for the given resource,
+     * replacing the previous version if any, and assign it a new version.
+     * Returns the reference to the stored array.
+     */
+    ArrayRef put(ResourceID id, std::shared_ptr<Array> array) {
+        std::unique_lock<tl::mutex> lock{m_mutex};
+        array->ref.version = m_next_version++;
+        Key key{id, array->ref.name};
+        auto it = m_index.find(key);
+        if(it != m_index.end()) remove(it);
+        m_entries.emplace_front(key, array);
+        m_index[key] = m_entries.begin();
+        m_bytes += array->data.size();
+        while(m_bytes > m_max_bytes || m_entries.size() > m_max_arrays) {
+            m_evictions += 1;
+            remove(m_index.find(m_entries.back().first));
+        }
+        return array->ref;
+    }
+
+    /**
+     * @brief Return the array referenced by ref for the given resource,
+     * or nullptr if it is not stored (or if its version differs from
+     * ref's non-zero version).
+     */
+    std::shared_ptr<const Array> get(ResourceID id, const ArrayRef& ref) {
+        std::unique_lock<tl::mutex> lock{m_mutex};
+        auto it = m_index.find(Key{id, ref.name});
+        if(it == m_index.end() || (ref.version != 0 && it->second->second->ref.version != ref.version)) {
+            m_misses += 1;
+            return nullptr;
+        }
+        m_hits += 1;
+        m_entries.splice(m_entries.begin(), m_entries, it->second);
+        return it->second->second;
+    }
+
+    /**
+     * @brief Remove the array with the given name. Returns false if
+     * there was no such array.
+     */
+    bool drop(ResourceID id, const std::string& name) {
+        std::unique_lock<tl::mutex> lock{m_mutex};
+        auto it = m_index.find(Key{id, name});
+        if(it == m_index.end()) return false;
+        remove(it);
+        return true;
+    }
+
+    /**
+     * @brief Remove the array referenced by ref only if the stored version
+     * is still ref's version. Returns false otherwise.
+     */
+    bool drop(ResourceID id, const ArrayRef& ref) {
+        std::unique_lock<tl::mutex> lock{m_mutex};
+        auto it = m_index.find(Key{id, ref.name});
+        if(it == m_index.end() || it->second->second->ref.version != ref.version)
+            return false;
+        remove(it);
+        return true;
+    }
+
+    /**
+     * @brief Remove all the arrays of the given resource.
+     */
+    void dropResource(ResourceID id) {
+        std::unique_lock<tl::mutex> lock{m_mutex};
+        auto it = m_index.lower_bound(Key{id, std::string{}});
+        while(it != m_index.end() && it->first.first == id)
+            it = remove(it);
+    }
+
+    /**
+     * @brief Return the store's configuration.
+     */
+    json getConfig() const {
+        return json{{"max_bytes", m_max_bytes}, {"max_arrays", m_max_arrays}};
+    }
+
+    /**
+     * @brief Return hit/miss/eviction counters and the size of the store.
+     */
+    json getStats() const {
+        std::unique_lock<tl::mutex> lock{m_mutex};
+        return json{
+            {"hits", m_hits},
+            {"misses", m_misses},
+            {"evictions", m_evictions},
+            {"arrays", m_entries.size()},
+            {"bytes", m_bytes}
+        };
+    }
+
+    private:
+
+    using Key   = std::pair<ResourceID, std::string>;
+    using Entry = std::pair<Key, std::shared_ptr<Array>>;
+    using Index = std::map<Key, std::list<Entry>::iterator>;
+
+    Index::iterator remove(Index::iterator it) {
+        m_bytes -= it->second->second->data.size();
+        m_entries.erase(it->second);
+        return m_index.erase(it);
+    }
+
+    size_t            m_max_bytes;
+    size_t            m_max_arrays;
+    mutable tl::mutex m_mutex;
+    std::list<Entry>  m_entries;
+    Index             m_index;
+    size_t            m_bytes        = 0;
+    uint64_t          m_next_version = 1;
+    size_t            m_hits         = 0;
+    size_t            m_misses       = 0;
+    size_t            m_evictions    = 0;
+};
+
+}
+
+#endif
@@ -8,6 +8,8 @@
 
 #include <bedrock/AbstractComponent.hpp>
 
+#include <unordered_map>
+
 namespace tl = thallium;
 
 class AlphaComponent : public bedrock::AbstractComponent {
@@ -19,8 +21,9 @@ class AlphaComponent : public bedrock::AbstractComponent {
     AlphaComponent(const tl::engine& engine,
                     uint16_t  provider_id,
                     const std::string& config,
-                    const tl::pool& pool)
-    : m_provider{std::make_unique<alpha::Provider>(engine, provider_id, config, pool)}
+                    const tl::pool& pool,
+                    const std::unordered_map<std::string, tl::pool>& named_pools)
+    : m_provider{std::make_unique<alpha::Provider>(engine, provider_id, config, pool, named_pools)}
     {}
 
     void* getHandle() override {
@@ -38,8 +41,16 @@ class AlphaComponent : public bedrock::AbstractComponent {
             if(it != args.dependencies.end() && !it->second.empty()) {
                 pool = it->second[0]->getHandle<tl::pool>();
             }
+            // pools listed in the "pools" dependency can be referred to
+            // by name in the "rpc_pools" field of the configuration
+            std::unordered_map<std::string, tl::pool> named_pools;
+            it = args.dependencies.find("pools");
+            if(it != args.dependencies.end()) {
+                for(auto& dependency : it->second)
+                    named_pools[dependency->getName()] = dependency->getHandle<tl::pool>();
+            }
             return std::make_shared<AlphaComponent>(
-                args.engine, args.provider_id, args.config, pool);
+                args.engine, args.provider_id, args.config, pool, named_pools);
         }
 
     static std::vector<bedrock::Dependency>
@@ -52,6 +63,13 @@ class AlphaComponent : public bedrock::AbstractComponent {
                     /* is_required */ false,
                     /* is_array */ false,
                     /* is_updatable */ false
+                },
+                bedrock::Dependency{
+                    /* name */ "pools",
+                    /* type */ "pool",
+                    /* is_required */ false,
+                    /* is_array */ true,
+                    /* is_updatable */ false
                 }
             };
             return dependencies;
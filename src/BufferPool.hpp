@@ -0,0 +1,290 @@
+/*
+ * (C) 2024 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#ifndef __ALPHA_BUFFER_POOL_H
+#define __ALPHA_BUFFER_POOL_H
+
+#include <alpha/Exception.hpp>
+
+#include <thallium.hpp>
+#include <nlohmann/json.hpp>
+
+#include <sys/mman.h>
+#include <algorithm>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace alpha {
+
+namespace tl = thallium;
+
+/**
+ * @brief The BufferPool holds buffers that have been exposed for RDMA
+ * once and can be borrowed by RPC handlers, avoiding a memory registration
+ * per request. Buffers are grouped in size classes. A request for N bytes is
+ * served by the smallest size class that can hold N bytes. Up to "capacity"
+ * buffers are kept per size class; requests that cannot be served from the
+ * pool (all buffers of the class are in use, or N exceeds the largest class)
+ * get a temporary buffer that is released when the lease ends.
+ */
+class BufferPool {
+
+    using json = nlohmann::json;
+
+    static constexpr size_t s_hugepage_size = 2*1024*1024;
+
+    struct Buffer {
+        char*    data = nullptr;
+        size_t   size = 0;
+        tl::bulk bulk;
+    };
+
+    struct SizeClass {
+        size_t               size;
+        size_t               allocated = 0;
+        std::vector<Buffer*> free;
+    };
+
+    public:
+
+    /**
+     * @brief RAII object giving access to a buffer borrowed from
+     * the pool. The buffer is returned to the pool when the Lease
+     * is destroyed.
+     */
+    class Lease {
+
+        friend class BufferPool;
+
+        BufferPool* m_pool       = nullptr;
+        Buffer*     m_buffer     = nullptr;
+        SizeClass*  m_size_class = nullptr;
+
+        Lease(BufferPool* pool, Buffer* buffer, SizeClass* size_class)
+        : m_pool(pool)
+        , m_buffer(buffer)
+        , m_size_class(size_class) {}
+
+        public:
+
+        Lease() = default;
+
+        Lease(Lease&& other)
+        : m_pool(std::exchange(other.m_pool, nullptr))
+        , m_buffer(std::exchange(other.m_buffer, nullptr))
+        , m_size_class(std::exchange(other.m_size_class, nullptr)) {}
+
+        Lease& operator=(Lease&& other) {
+            if(this == &other) return *this;
+            release();
+            m_pool       = std::exchange(other.m_pool, nullptr);
+            m_buffer     = std::exchange(other.m_buffer, nullptr);
+            m_size_class = std::exchange(other.m_size_class, nullptr);
+            return *this;
+        }
+
+        Lease(const Lease&) = delete;
+
+        Lease& operator=(const Lease&) = delete;
+
+        ~Lease() {
+            release();
+        }
+
+        char* data() const {
+            return m_buffer->data;
+        }
+
+        size_t size() const {
+            return m_buffer->size;
+        }
+
+        const tl::bulk& bulk() const {
+            return m_buffer->bulk;
+        }
+
+        private:
+
+        void release() {
+            if(m_pool) m_pool->release(m_buffer, m_size_class);
+            m_pool = nullptr;
+        }
+    };
+
+    /**
+     * @brief Constructor.
+     *
+     * @param engine Thallium engine used to expose the buffers.
+     * @param size_classes Sizes (in bytes) of the buffers held by the pool.
+     * @param capacity Maximum number of buffers kept per size class.
+     * @param use_hugepages Whether to back buffers with hugepages.
+     * @param preallocate Whether to allocate all the buffers upfront.
+     */
+    BufferPool(const tl::engine& engine,
+               std::vector<size_t> size_classes,
+               size_t capacity,
+               bool use_hugepages,
+               bool preallocate)
+    : m_engine(engine)
+    , m_capacity(capacity)
+    , m_use_hugepages(use_hugepages)
+    , m_preallocate(preallocate) {
+        std::sort(size_classes.begin(), size_classes.end());
+        size_classes.erase(std::unique(size_classes.begin(), size_classes.end()), size_classes.end());
+        m_size_classes.reserve(size_classes.size());
+        for(auto size : size_classes) m_size_classes.push_back(SizeClass{size, 0, {}});
+        if(!preallocate) return;
+        for(auto& size_class : m_size_classes) {
+            for(size_t i = 0; i < m_capacity; ++i) {
+                size_class.free.push_back(allocate(size_class.size));
+                size_class.allocated += 1;
+            }
+        }
+    }
+
+    BufferPool(const BufferPool&) = delete;
+
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    ~BufferPool() {
+        for(auto& size_class : m_size_classes)
+            for(auto buffer : size_class.free)
+                deallocate(buffer);
+    }
+
+    /**
+     * @brief Borrow a buffer of at least the requested size.
+     */
+    Lease borrow(size_t size) {
+        auto it = std::lower_bound(m_size_classes.begin(), m_size_classes.end(), size,
+            [](const SizeClass& c, size_t s) { return c.size < s; });
+        if(it == m_size_classes.end()) {
+            {
+                std::unique_lock<tl::mutex> lock{m_mutex};
+                m_misses += 1;
+            }
+            return Lease{this, allocate(size), nullptr};
+        }
+        SizeClass* size_class = &(*it);
+        bool pooled = false;
+        {
+            std::unique_lock<tl::mutex> lock{m_mutex};
+            if(!size_class->free.empty()) {
+                m_hits += 1;
+                auto buffer = size_class->free.back();
+                size_class->free.pop_back();
+                return Lease{this, buffer, size_class};
+            }
+            m_misses += 1;
+            if(size_class->allocated < m_capacity) {
+                size_class->allocated += 1;
+                pooled = true;
+            }
+        }
+        // allocation and registration happen outside of the lock
+        try {
+            return Lease{this, allocate(size_class->size), pooled ? size_class : nullptr};
+        } catch(...) {
+            if(pooled) {
+                std::unique_lock<tl::mutex> lock{m_mutex};
+                size_class->allocated -= 1;
+            }
+            throw;
+        }
+    }
+
+    /**
+     * @brief Return the pool's configuration.
+     */
+    json getConfig() const {
+        auto config = json::object();
+        config["size_classes"] = json::array();
+        for(auto& size_class : m_size_classes)
+            config["size_classes"].push_back(size_class.size);
+        config["capacity"]    = m_capacity;
+        config["hugepages"]   = m_use_hugepages;
+        config["preallocate"] = m_preallocate;
+        return config;
+    }
+
+    /**
+     * @brief Return hit/miss counters and per-class occupancy.
+     */
+    json getStats() const {
+        std::unique_lock<tl::mutex> lock{m_mutex};
+        auto stats = json::object();
+        stats["hits"]   = m_hits;
+        stats["misses"] = m_misses;
+        stats["size_classes"] = json::array();
+        for(auto& size_class : m_size_classes) {
+            stats["size_classes"].push_back({
+                {"size", size_class.size},
+                {"allocated", size_class.allocated},
+                {"free", size_class.free.size()}
+            });
+        }
+        return stats;
+    }
+
+    private:
+
+    Buffer* allocate(size_t size) {
+        auto buffer = new Buffer{};
+        size = std::max<size_t>(size, 1);
+        void* data = MAP_FAILED;
+        if(m_use_hugepages) {
+            buffer->size = ((size + s_hugepage_size - 1)/s_hugepage_size)*s_hugepage_size;
+            data = mmap(nullptr, buffer->size, PROT_READ|PROT_WRITE,
+                        MAP_PRIVATE|MAP_ANONYMOUS|MAP_HUGETLB, -1, 0);
+        }
+        if(data == MAP_FAILED) {
+            // no hugepages requested, or none available
+            buffer->size = size;
+            data = mmap(nullptr, buffer->size, PROT_READ|PROT_WRITE,
+                        MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+        }
+        if(data == MAP_FAILED) {
+            delete buffer;
+            throw Exception{"Could not allocate buffer for bulk transfers"};
+        }
+        buffer->data = static_cast<char*>(data);
+        try {
+            buffer->bulk = m_engine.expose({{data, buffer->size}}, tl::bulk_mode::read_write);
+        } catch(...) {
+            deallocate(buffer);
+            throw;
+        }
+        return buffer;
+    }
+
+    void deallocate(Buffer* buffer) {
+        buffer->bulk = tl::bulk{};
+        munmap(buffer->data, buffer->size);
+        delete buffer;
+    }
+
+    void release(Buffer* buffer, SizeClass* size_class) {
+        if(!size_class) {
+            deallocate(buffer);
+            return;
+        }
+        std::unique_lock<tl::mutex> lock{m_mutex};
+        size_class->free.push_back(buffer);
+    }
+
+    tl::engine             m_engine;
+    std::vector<SizeClass> m_size_classes;
+    size_t                 m_capacity;
+    bool                   m_use_hugepages;
+    bool                   m_preallocate;
+    mutable tl::mutex      m_mutex;
+    size_t                 m_hits   = 0;
+    size_t                 m_misses = 0;
+};
+
+}
+
+#endif
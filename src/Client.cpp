@@ -19,11 +19,11 @@ namespace alpha {
 
 Client::Client() = default;
 
-Client::Client(const tl::engine& engine)
-: self(std::make_shared<ClientImpl>(engine)) {}
+Client::Client(const tl::engine& engine, const std::string& config)
+: self(std::make_shared<ClientImpl>(engine, config)) {}
 
-Client::Client(margo_instance_id mid)
-: self(std::make_shared<ClientImpl>(mid)) {}
+Client::Client(margo_instance_id mid, const std::string& config)
+: self(std::make_shared<ClientImpl>(mid, config)) {}
 
 Client::Client(const std::shared_ptr<ClientImpl>& impl)
 : self(impl) {}
@@ -51,6 +51,14 @@ ResourceHandle Client::makeResourceHandle(
         const std::string& address,
         uint16_t provider_id,
         bool check) const {
+    return makeResourceHandle(address, provider_id, ResourceID{0}, check);
+}
+
+ResourceHandle Client::makeResourceHandle(
+        const std::string& address,
+        uint16_t provider_id,
+        ResourceID resource_id,
+        bool check) const {
     auto endpoint  = self->m_engine.lookup(address);
     auto ph        = tl::provider_handle(endpoint, provider_id);
     if(check) {
@@ -61,12 +69,39 @@ ResourceHandle Client::makeResourceHandle(
         } catch(const std::exception& ex) {
             throw Exception{ex.what()};
         }
+        Result<bool> result = self->m_check_resource.on(ph)(resource_id);
+        result.check();
     }
-    return std::make_shared<ResourceHandleImpl>(self, std::move(ph));
+    return std::make_shared<ResourceHandleImpl>(self, std::move(ph), resource_id);
+}
+
+ResourceHandle Client::createResource(
+        const std::string& address,
+        uint16_t provider_id,
+        const std::string& type,
+        const std::string& config) const {
+    auto endpoint  = self->m_engine.lookup(address);
+    auto ph        = tl::provider_handle(endpoint, provider_id);
+    Result<ResourceID> result = self->m_create_resource.on(ph)(type, config);
+    return std::make_shared<ResourceHandleImpl>(self, std::move(ph), result.valueOrThrow());
+}
+
+RegisteredBuffer Client::registerBuffer(void* data, size_t size, tl::bulk_mode mode) const {
+    if(not self) throw Exception("Invalid alpha::Client object");
+    auto bulk = self->m_engine.expose({{data, size}}, mode);
+    return RegisteredBuffer{std::move(bulk), self->m_engine.self(), data, size, mode};
+}
+
+void Client::clearRegistrationCache() const {
+    if(self) self->m_registration_cache.clear();
 }
 
 std::string Client::getConfig() const {
-    return "{}";
+    return self ? self->getConfig() : "{}";
+}
+
+std::string Client::dumpTrace() const {
+    return self ? self->m_tracer.dump() : "{}";
 }
 
 }
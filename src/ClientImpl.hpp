@@ -6,33 +6,184 @@
 #ifndef __ALPHA_CLIENT_IMPL_H
 #define __ALPHA_CLIENT_IMPL_H
 
+#include "alpha/Exception.hpp"
+#include "RegistrationCache.hpp"
+#include "Tracing.hpp"
+
 #include <thallium.hpp>
 #include <thallium/serialization/stl/unordered_set.hpp>
 #include <thallium/serialization/stl/unordered_map.hpp>
 #include <thallium/serialization/stl/string.hpp>
+#include <thallium/serialization/stl/vector.hpp>
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <chrono>
 
 namespace alpha {
 
 namespace tl = thallium;
 
+/**
+ * @brief How requests rejected with a retryable error are retried:
+ * up to max_attempts attempts in total, waiting between attempts for a
+ * random duration between half and all of the current backoff, which
+ * starts at initial_backoff and doubles after each attempt, up to max_backoff.
+ */
+struct RetryPolicy {
+    size_t                    max_attempts = 8;
+    std::chrono::microseconds initial_backoff{1000};
+    std::chrono::microseconds max_backoff{100000};
+};
+
 class ClientImpl {
 
+    using json = nlohmann::json;
+
     public:
 
     tl::engine           m_engine;
     tl::remote_procedure m_compute_sum;
     tl::remote_procedure m_compute_sum_bulk;
+    tl::remote_procedure m_compute_sums_inline;
+    tl::remote_procedure m_get_stats;
+    tl::remote_procedure m_create_resource;
+    tl::remote_procedure m_destroy_resource;
+    tl::remote_procedure m_check_resource;
+    tl::remote_procedure m_reduce;
+    tl::remote_procedure m_scan;
+    tl::remote_procedure m_evaluate;
+    tl::remote_procedure m_put_array;
+    tl::remote_procedure m_drop_array;
+    tl::remote_procedure m_compute_sums_with_array;
+    RegistrationCache    m_registration_cache;
+    size_t               m_inline_threshold;
+    Tracer               m_tracer;
+    RetryPolicy          m_retry;
+
+    ClientImpl(const tl::engine& engine, const std::string& config)
+    : ClientImpl(engine, parseConfig(config)) {}
 
-    ClientImpl(const tl::engine& engine)
+    ClientImpl(margo_instance_id mid, const std::string& config)
+    : ClientImpl(tl::engine(mid), config) {}
+
+    ~ClientImpl() {}
+
+    std::string getConfig() const {
+        auto config = json::object();
+        config["registration_cache"] = json::object();
+        config["registration_cache"]["capacity"] = m_registration_cache.capacity();
+        config["inline_threshold"] = m_inline_threshold;
+        config["tracing"] = m_tracer.getConfig();
+        config["retry"] = json::object();
+        config["retry"]["max_attempts"] = m_retry.max_attempts;
+        config["retry"]["initial_backoff_us"] = m_retry.initial_backoff.count();
+        config["retry"]["max_backoff_us"] = m_retry.max_backoff.count();
+        return config.dump();
+    }
+
+    private:
+
+    ClientImpl(const tl::engine& engine, const json& config)
     : m_engine(engine)
     , m_compute_sum(m_engine.define("alpha_compute_sum"))
     , m_compute_sum_bulk(m_engine.define("alpha_compute_sum_bulk"))
+    , m_compute_sums_inline(m_engine.define("alpha_compute_sums_inline"))
+    , m_get_stats(m_engine.define("alpha_get_stats"))
+    , m_create_resource(m_engine.define("alpha_create_resource"))
+    , m_destroy_resource(m_engine.define("alpha_destroy_resource"))
+    , m_check_resource(m_engine.define("alpha_check_resource"))
+    , m_reduce(m_engine.define("alpha_reduce"))
+    , m_scan(m_engine.define("alpha_scan"))
+    , m_evaluate(m_engine.define("alpha_evaluate"))
+    , m_put_array(m_engine.define("alpha_put_array"))
+    , m_drop_array(m_engine.define("alpha_drop_array"))
+    , m_compute_sums_with_array(m_engine.define("alpha_compute_sums_with_array"))
+    , m_registration_cache(m_engine, registrationCacheCapacity(config))
+    , m_inline_threshold(inlineThreshold(m_engine, config))
+    , m_tracer("alpha-client", config.contains("tracing") ? config["tracing"] : json{})
+    , m_retry(retryPolicy(config))
     {}
 
-    ClientImpl(margo_instance_id mid)
-    : ClientImpl(tl::engine(mid)) {}
+    static json parseConfig(const std::string& config) {
+        json json_config;
+        try {
+            json_config = json::parse(config);
+        } catch(json::parse_error& e) {
+            throw Exception{std::string{"Could not parse client configuration: "} + e.what()};
+        }
+        if(!json_config.is_object())
+            throw Exception{"Alpha client configuration should be an object"};
+        return json_config;
+    }
 
-    ~ClientImpl() {}
+    static size_t registrationCacheCapacity(const json& config) {
+        // TUTORIAL
+        // ********
+        //
+        // The "registration_cache" field enables caching bulk handles created by
+        // ResourceHandle::computeSums, keyed by (pointer, size, mode). It is disabled
+        // (capacity 0) by default since cached registrations become invalid if the
+        // memory is freed, see RegistrationCache.hpp.
+        if(!config.contains("registration_cache")) return 0;
+        auto& cache = config["registration_cache"];
+        if(!cache.is_object())
+            throw Exception{"\"registration_cache\" field in Alpha client configuration should be an object"};
+        if(!cache.contains("capacity")) return 0;
+        if(!cache["capacity"].is_number_unsigned())
+            throw Exception{"\"capacity\" field in Alpha client configuration should be a positive integer"};
+        return cache["capacity"].get<size_t>();
+    }
+
+    static RetryPolicy retryPolicy(const json& config) {
+        // TUTORIAL
+        // ********
+        //
+        // The "retry" field controls how requests that a provider rejected because it
+        // was overloaded are retried (see RetryPolicy): "max_attempts" (1 disables
+        // retries), "initial_backoff_us" and "max_backoff_us". Only errors flagged as
+        // retryable by the provider are retried.
+        RetryPolicy policy;
+        if(!config.contains("retry")) return policy;
+        auto& retry = config["retry"];
+        if(!retry.is_object())
+            throw Exception{"\"retry\" field in Alpha client configuration should be an object"};
+        auto field = [&retry](const char* name, size_t default_value, size_t min_value) -> size_t {
+            if(!retry.contains(name)) return default_value;
+            if(!retry[name].is_number_unsigned() || retry[name].get<size_t>() < min_value)
+                throw Exception{std::string{"\""} + name + "\" field in Alpha client configuration "
+                                "should be an integer greater or equal to " + std::to_string(min_value)};
+            return retry[name].get<size_t>();
+        };
+        policy.max_attempts    = field("max_attempts", policy.max_attempts, 1);
+        policy.initial_backoff = std::chrono::microseconds{
+            field("initial_backoff_us", policy.initial_backoff.count(), 0)};
+        policy.max_backoff     = std::chrono::microseconds{
+            field("max_backoff_us", policy.max_backoff.count(), 0)};
+        return policy;
+    }
+
+    static size_t inlineThreshold(const tl::engine& engine, const json& config) {
+        // TUTORIAL
+        // ********
+        //
+        // The "inline_threshold" field is the maximum size (in bytes) of each input
+        // array for which ResourceHandle::computeSums sends the data inline in the RPC
+        // instead of using RDMA. Its default value, "auto", derives it from Mercury's
+        // eager buffer sizes so that requests and responses fit in a single message.
+        if(config.contains("inline_threshold") && config["inline_threshold"].is_number_unsigned())
+            return config["inline_threshold"].get<size_t>();
+        if(config.contains("inline_threshold") && config["inline_threshold"] != "auto")
+            throw Exception{"\"inline_threshold\" field in Alpha client configuration should be "
+                            "a positive integer or \"auto\""};
+        // x and y both go in the input, leaving room for the RPC's own headers
+        constexpr size_t overhead = 128;
+        auto hg_class = margo_get_class(engine.get_margo_instance());
+        size_t eager_size = std::min(HG_Class_get_input_eager_size(hg_class),
+                                     HG_Class_get_output_eager_size(hg_class));
+        return eager_size > overhead ? (eager_size - overhead)/2 : 0;
+    }
 };
 
 }
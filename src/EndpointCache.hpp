@@ -0,0 +1,111 @@
+/*
+ * (C) 2024 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#ifndef __ALPHA_ENDPOINT_CACHE_H
+#define __ALPHA_ENDPOINT_CACHE_H
+
+#include <thallium.hpp>
+#include <nlohmann/json.hpp>
+
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace alpha {
+
+namespace tl = thallium;
+
+/**
+ * @brief The EndpointCache keeps the endpoints resulting from
+ * engine.lookup() calls, indexed by address, so that requests coming
+ * from the same client do not need to resolve its address again.
+ * The least recently used endpoint is evicted when the cache is full.
+ * A capacity of 0 disables caching.
+ */
+class EndpointCache {
+
+    using json = nlohmann::json;
+    using Entry = std::pair<std::string, tl::endpoint>;
+
+    public:
+
+    /**
+     * @brief Constructor.
+     *
+     * @param engine Thallium engine used to lookup addresses.
+     * @param capacity Maximum number of endpoints kept in the cache.
+     */
+    EndpointCache(const tl::engine& engine, size_t capacity)
+    : m_engine(engine)
+    , m_capacity(capacity) {}
+
+    EndpointCache(const EndpointCache&) = delete;
+
+    EndpointCache& operator=(const EndpointCache&) = delete;
+
+    /**
+     * @brief Return the endpoint corresponding to the address,
+     * resolving it only if it is not already in the cache.
+     */
+    tl::endpoint lookup(const std::string& address) {
+        {
+            std::unique_lock<tl::mutex> lock{m_mutex};
+            auto it = m_index.find(address);
+            if(it != m_index.end()) {
+                m_hits += 1;
+                m_entries.splice(m_entries.begin(), m_entries, it->second);
+                return it->second->second;
+            }
+            m_misses += 1;
+        }
+        // address resolution may block, so it is done outside of the lock
+        auto endpoint = m_engine.lookup(address);
+        if(m_capacity == 0) return endpoint;
+        std::unique_lock<tl::mutex> lock{m_mutex};
+        if(m_index.find(address) != m_index.end())
+            return endpoint; // another ULT inserted it in the meantime
+        m_entries.emplace_front(address, endpoint);
+        m_index[address] = m_entries.begin();
+        if(m_entries.size() > m_capacity) {
+            m_index.erase(m_entries.back().first);
+            m_entries.pop_back();
+        }
+        return endpoint;
+    }
+
+    /**
+     * @brief Return the cache's configuration.
+     */
+    json getConfig() const {
+        return json{{"capacity", m_capacity}};
+    }
+
+    /**
+     * @brief Return hit/miss counters and the number of cached endpoints.
+     */
+    json getStats() const {
+        std::unique_lock<tl::mutex> lock{m_mutex};
+        return json{
+            {"hits", m_hits},
+            {"misses", m_misses},
+            {"size", m_entries.size()}
+        };
+    }
+
+    private:
+
+    tl::engine        m_engine;
+    size_t            m_capacity;
+    mutable tl::mutex m_mutex;
+    std::list<Entry>  m_entries;
+    std::unordered_map<std::string, std::list<Entry>::iterator> m_index;
+    size_t            m_hits   = 0;
+    size_t            m_misses = 0;
+};
+
+}
+
+#endif
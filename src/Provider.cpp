@@ -18,6 +18,12 @@ Provider::Provider(const tl::engine& engine, uint16_t provider_id, const std::st
     self->get_engine().push_finalize_callback(this, [p=this]() { p->self.reset(); });
 }
 
+Provider::Provider(const tl::engine& engine, uint16_t provider_id, const std::string& config, const tl::pool& p,
+                   const std::unordered_map<std::string, tl::pool>& named_pools)
+: self(std::make_shared<ProviderImpl>(engine, provider_id, config, p, named_pools)) {
+    self->get_engine().push_finalize_callback(this, [p=this]() { p->self.reset(); });
+}
+
 Provider::Provider(Provider&& other) {
     other.self->get_engine().pop_finalize_callback(&other);
     self = std::move(other.self);
@@ -34,6 +40,14 @@ std::string Provider::getConfig() const {
     return self ? self->getConfig() : "{}";
 }
 
+std::string Provider::getStats() const {
+    return self ? self->getStats().dump() : "{}";
+}
+
+std::string Provider::dumpTrace() const {
+    return self ? self->dumpTrace() : "{}";
+}
+
 Provider::operator bool() const {
     return static_cast<bool>(self);
 }
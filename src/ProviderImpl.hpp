@@ -7,7 +7,18 @@
 #define __ALPHA_PROVIDER_IMPL_H
 
 #include "alpha/ResourceInterface.hpp"
+#include "alpha/ResourceID.hpp"
 #include "alpha/BulkLocation.hpp"
+#include "alpha/Reduction.hpp"
+#include "alpha/Scan.hpp"
+#include "alpha/Expression.hpp"
+#include "alpha/ArrayRef.hpp"
+#include "BufferPool.hpp"
+#include "EndpointCache.hpp"
+#include "ArrayStore.hpp"
+#include "AdmissionControl.hpp"
+#include "Statistics.hpp"
+#include "Tracing.hpp"
 
 #include <thallium.hpp>
 #include <thallium/serialization/stl/string.hpp>
@@ -16,8 +27,17 @@
 #include <nlohmann/json.hpp>
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
+#include <chrono>
+#include <exception>
 #include <format>
+#include <map>
+#include <optional>
+#include <shared_mutex>
+#include <span>
+#include <thread>
 #include <tuple>
+#include <unordered_map>
 
 namespace alpha {
 
@@ -50,19 +70,108 @@ class ProviderImpl : public tl::provider<ProviderImpl> {
 
     tl::engine           m_engine;
     tl::pool             m_pool;
+    // Configuration (parsed before the RPCs are defined, since it
+    // determines the pool each RPC is associated with)
+    json                 m_config;
+    // Pools provided by name (e.g. by Bedrock) and pool of each RPC
+    std::unordered_map<std::string, tl::pool> m_named_pools;
+    std::map<std::string, std::string>        m_rpc_pool_names;
     // Client RPC
     tl::auto_remote_procedure m_compute_sum;
     tl::auto_remote_procedure m_compute_sum_bulk;
+    tl::auto_remote_procedure m_compute_sums_inline;
+    tl::auto_remote_procedure m_get_stats;
+    tl::auto_remote_procedure m_create_resource;
+    tl::auto_remote_procedure m_destroy_resource;
+    tl::auto_remote_procedure m_check_resource;
+    tl::auto_remote_procedure m_reduce;
+    tl::auto_remote_procedure m_scan;
+    tl::auto_remote_procedure m_evaluate;
+    tl::auto_remote_procedure m_put_array;
+    tl::auto_remote_procedure m_drop_array;
+    tl::auto_remote_procedure m_compute_sums_with_array;
     // FIXME: other RPCs go here ...
-    // ResourceInterfaces
-    std::shared_ptr<ResourceInterface> m_backend;
+    // ResourceInterfaces, indexed by ResourceID. The lock is only held
+    // to look up, insert, or remove resources, never while using them or
+    // while taking a lock that may yield the ULT (e.g. a tl::mutex).
+    mutable std::shared_mutex m_resources_mutex;
+    std::unordered_map<ResourceID, std::shared_ptr<ResourceInterface>> m_resources;
+    uint32_t                  m_next_resource_id = 1;
+    // Bulk transfer settings
+    size_t m_chunk_size     = 4*1024*1024;
+    size_t m_pipeline_depth = 4;
+    // Pre-registered buffers used for bulk transfers
+    std::unique_ptr<BufferPool> m_buffer_pool;
+    // Cache of endpoints of the clients sending bulk requests
+    std::unique_ptr<EndpointCache> m_endpoint_cache;
+    // Arrays uploaded by clients to be used as operands
+    std::unique_ptr<ArrayStore> m_array_store;
+    // Bound on the memory used by bulk requests in flight
+    std::unique_ptr<AdmissionControl> m_admission;
+    // Pool in which the workers of bulk requests run
+    tl::pool m_bulk_pool;
+    // Parallel computation settings
+    tl::pool    m_compute_pool;
+    std::string m_compute_pool_name;
+    size_t      m_grain_size = 64*1024;
+    size_t      m_max_tasks  = std::max(1u, std::thread::hardware_concurrency());
+    // Performance counters, and index of each RPC in them
+    Statistics m_stats;
+    struct {
+        size_t compute_sum;
+        size_t compute_sum_bulk;
+        size_t compute_sums_inline;
+        size_t get_stats;
+        size_t create_resource;
+        size_t destroy_resource;
+        size_t check_resource;
+        size_t reduce;
+        size_t scan;
+        size_t evaluate;
+        size_t put_array;
+        size_t drop_array;
+        size_t compute_sums_with_array;
+    } m_stats_ids;
+    // Tracing of the phases of each request
+    std::unique_ptr<Tracer> m_tracer;
+    // Server-side coalescing of computeSum requests
+    struct PendingSum {
+        tl::request                        req;
+        std::shared_ptr<ResourceInterface> resource;
+        int32_t                            x;
+        int32_t                            y;
+    };
+    bool                      m_coalescing = false;
+    std::chrono::microseconds m_coalescing_window{100};
+    size_t                    m_coalescing_max_batch = 1024;
+    tl::mutex                 m_pending_sums_mutex;
+    tl::condition_variable    m_pending_sums_cv;
+    std::vector<PendingSum>   m_pending_sums;
+    bool                      m_stop_coalescing = false;
+    std::optional<tl::managed<tl::thread>> m_coalescing_ult;
 
-    ProviderImpl(const tl::engine& engine, uint16_t provider_id, const std::string& config, const tl::pool& pool)
+    ProviderImpl(const tl::engine& engine, uint16_t provider_id, const std::string& config, const tl::pool& pool,
+                 const std::unordered_map<std::string, tl::pool>& named_pools = {})
     : tl::provider<ProviderImpl>(engine, provider_id, "alpha")
     , m_engine(engine)
-    , m_pool(pool)
-    , m_compute_sum(define("alpha_compute_sum",  &ProviderImpl::computeSumRPC, pool))
-    , m_compute_sum_bulk(define("alpha_compute_sum_bulk",  &ProviderImpl::computeSumBulkRPC, pool))
+    , m_pool(pool.is_null() ? engine.get_handler_pool() : pool)
+    , m_config(json::parse(config, nullptr, false))
+    , m_named_pools(named_pools)
+    , m_compute_sum(define("alpha_compute_sum",  &ProviderImpl::computeSumRPC, rpcPool("alpha_compute_sum")))
+    , m_compute_sum_bulk(define("alpha_compute_sum_bulk",  &ProviderImpl::computeSumBulkRPC, rpcPool("alpha_compute_sum_bulk")))
+    , m_compute_sums_inline(define("alpha_compute_sums_inline",  &ProviderImpl::computeSumsInlineRPC, rpcPool("alpha_compute_sums_inline")))
+    , m_get_stats(define("alpha_get_stats",  &ProviderImpl::getStatsRPC, rpcPool("alpha_get_stats")))
+    , m_create_resource(define("alpha_create_resource",  &ProviderImpl::createResourceRPC, rpcPool("alpha_create_resource")))
+    , m_destroy_resource(define("alpha_destroy_resource",  &ProviderImpl::destroyResourceRPC, rpcPool("alpha_destroy_resource")))
+    , m_check_resource(define("alpha_check_resource",  &ProviderImpl::checkResourceRPC, rpcPool("alpha_check_resource")))
+    , m_reduce(define("alpha_reduce",  &ProviderImpl::reduceRPC, rpcPool("alpha_reduce")))
+    , m_scan(define("alpha_scan",  &ProviderImpl::scanRPC, rpcPool("alpha_scan")))
+    , m_evaluate(define("alpha_evaluate",  &ProviderImpl::evaluateRPC, rpcPool("alpha_evaluate")))
+    , m_put_array(define("alpha_put_array",  &ProviderImpl::putArrayRPC, rpcPool("alpha_put_array")))
+    , m_drop_array(define("alpha_drop_array",  &ProviderImpl::dropArrayRPC, rpcPool("alpha_drop_array")))
+    , m_compute_sums_with_array(define("alpha_compute_sums_with_array",
+                                       &ProviderImpl::computeSumsWithArrayRPC,
+                                       rpcPool("alpha_compute_sums_with_array")))
     {
         // TUTORIAL
         // ********
@@ -70,53 +179,410 @@ class ProviderImpl : public tl::provider<ProviderImpl> {
         // Typically, the configuration is expected to have a "resource" field, with two
         // subfields: "type" (the type of resource, which should match a type registered with
         // the resource factory) and "config", which will be propagated to the resource's
-        // Create function.
+        // Create function. This resource gets ResourceID 0.
+        //
+        // A provider can host more resources, listed in an optional "resources" array. Each
+        // entry has the same "type" and "config" fields, and an optional "id" field (by default
+        // the next available ResourceID is used). Resources can also be created and destroyed
+        // at runtime by clients (see Client::createResource and ResourceHandle::destroy).
+        // All the resources share the provider's RPCs, pools, and buffers.
+        //
+        // An optional "bulk" field controls how computeSumBulkRPC moves data: arrays are
+        // processed in chunks of "chunk_size" bytes, with up to "pipeline_depth" chunks in
+        // flight at any time.
+        //
+        // An optional "buffer_pool" field configures the pool of pre-registered buffers
+        // used by these workers: "size_classes" (list of buffer sizes in bytes), "capacity"
+        // (maximum number of buffers kept per size class), "hugepages" (whether to back
+        // the buffers with hugepages) and "preallocate" (whether to allocate and register
+        // all the buffers when the provider starts).
+        //
+        // An optional "endpoint_cache" field with a "capacity" subfield sets the number of
+        // client endpoints kept to avoid resolving their address on every bulk request.
+        //
+        // An optional "arrays" field limits the memory used by the arrays that clients
+        // upload to be used as operands (see ResourceHandle::putArray): "max_bytes" is the
+        // maximum total size of the arrays (1 GiB by default) and "max_arrays" their maximum
+        // number (1024 by default). The least recently used arrays are evicted beyond these
+        // limits.
+        //
+        // An optional "admission" field bounds the memory used by bulk requests in flight
+        // (see AdmissionControl.hpp): "max_inflight_bytes" is the budget (0, the default,
+        // means unlimited) and "policy" is either "queue" (requests exceeding the budget
+        // wait for their turn) or "reject" (they fail immediately with a retryable error,
+        // and the client retries them after a backoff).
+        //
+        // An optional "compute" field controls how the computation on large arrays is split
+        // into tasks: "grain_size" is the minimum number of elements per task (smaller arrays
+        // are processed by the ULT handling the request), "max_tasks" is the maximum number
+        // of tasks per array, and "pool" is the name of the Argobots pool in which to run
+        // the tasks (by default, the provider's pool).
+        //
+        // An optional "coalescing" field enables server-side coalescing of computeSum
+        // requests ("enabled": true). Requests are then queued and processed by a single
+        // ULT, which waits "window_us" microseconds after the first queued request for
+        // other requests to arrive, then processes up to "max_batch" requests with one
+        // call to the backend's computeSums.
+        //
+        // An optional "tracing" field enables recording the phases of sampled requests
+        // (see Tracing.hpp), with subfields "enabled", "sample_rate" and "buffer_size".
+        // The recorded spans can be retrieved with Provider::dumpTrace().
+        //
+        // An optional "rpc_pools" field maps RPC names (e.g. "alpha_compute_sum") to the
+        // name of the pool in which they should be handled. Pool names are first looked up
+        // among the pools given to the provider by name (e.g. Bedrock's "pools" dependency),
+        // then among margo's pools. This allows separating latency-sensitive RPCs from RPCs
+        // moving large amounts of data, e.g. by giving them pools served by distinct
+        // execution streams, or a higher priority. RPCs that are not listed use the
+        // provider's pool. The ULTs moving data for bulk requests run in the pool of the
+        // "alpha_compute_sum_bulk" RPC (this includes the ULTs of the "alpha_reduce",
+        // "alpha_scan", "alpha_evaluate", and "alpha_compute_sums_with_array" RPCs).
         trace("Registered provider with id {}", get_provider_id());
-        json json_config;
-        try {
-            json_config = json::parse(config);
-        } catch(json::parse_error& e) {
-            error("Could not parse provider configuration: {}", e.what());
+        m_bulk_pool = rpcPool("alpha_compute_sum_bulk");
+        m_stats_ids.compute_sum         = m_stats.registerRPC("alpha_compute_sum");
+        m_stats_ids.compute_sum_bulk    = m_stats.registerRPC("alpha_compute_sum_bulk");
+        m_stats_ids.compute_sums_inline = m_stats.registerRPC("alpha_compute_sums_inline");
+        m_stats_ids.get_stats           = m_stats.registerRPC("alpha_get_stats");
+        m_stats_ids.create_resource     = m_stats.registerRPC("alpha_create_resource");
+        m_stats_ids.destroy_resource    = m_stats.registerRPC("alpha_destroy_resource");
+        m_stats_ids.check_resource      = m_stats.registerRPC("alpha_check_resource");
+        m_stats_ids.reduce              = m_stats.registerRPC("alpha_reduce");
+        m_stats_ids.scan                = m_stats.registerRPC("alpha_scan");
+        m_stats_ids.evaluate            = m_stats.registerRPC("alpha_evaluate");
+        m_stats_ids.put_array           = m_stats.registerRPC("alpha_put_array");
+        m_stats_ids.drop_array          = m_stats.registerRPC("alpha_drop_array");
+        m_stats_ids.compute_sums_with_array = m_stats.registerRPC("alpha_compute_sums_with_array");
+        if(m_config.is_discarded()) {
+            error("Could not parse provider configuration");
             return;
         }
+        auto& json_config = m_config;
         if(!json_config.is_object())
             throw Exception{"Alpha provider configuration should be an object"};
-        if(!json_config.contains("resource"))
+        if(json_config.contains("rpc_pools")) {
+            for(auto& [rpc_name, pool_name] : json_config["rpc_pools"].items()) {
+                if(!m_rpc_pool_names.count(rpc_name))
+                    throw Exception{std::format(
+                        "Unknown RPC \"{}\" in \"rpc_pools\" field of Alpha provider configuration",
+                        rpc_name)};
+            }
+        }
+        if(!json_config.contains("resource") && !json_config.contains("resources"))
             throw Exception{"\"resource\" field not found in Alpha provider configuration"};
-        auto& resource = json_config["resource"];
-        if(!resource.is_object())
-            throw Exception{"\"resource\" field in Alpha provider configuration should be an object"};
-        if(resource.contains("type") && resource["type"].is_string()) {
-            auto& resource_type = resource["type"].get_ref<const std::string&>();
-            auto resource_config = resource.contains("config") ? resource["config"] : json::object();
-            auto result = createResource(resource_type, resource_config);
-            result.check();
-        } else {
-            throw Exception{"\"type\" field not found in resource configuration for Alpha provider"};
+        if(json_config.contains("resource")) {
+            auto& resource = json_config["resource"];
+            if(!resource.is_object())
+                throw Exception{"\"resource\" field in Alpha provider configuration should be an object"};
+            createResourceFromConfig(resource, ResourceID{0});
         }
+        if(json_config.contains("resources")) {
+            auto& resources = json_config["resources"];
+            if(!resources.is_array())
+                throw Exception{"\"resources\" field in Alpha provider configuration should be an array"};
+            for(auto& resource : resources) {
+                if(!resource.is_object())
+                    throw Exception{"\"resources\" field in Alpha provider configuration should contain objects"};
+                std::optional<ResourceID> id;
+                if(resource.contains("id")) {
+                    if(!resource["id"].is_number_unsigned() || resource["id"].get<uint64_t>() > UINT32_MAX)
+                        throw Exception{"\"id\" field in Alpha resource configuration should be a 32-bit unsigned integer"};
+                    id = ResourceID{resource["id"].get<uint32_t>()};
+                }
+                createResourceFromConfig(resource, id);
+            }
+        }
+        if(json_config.contains("bulk")) {
+            auto& bulk = json_config["bulk"];
+            if(!bulk.is_object())
+                throw Exception{"\"bulk\" field in Alpha provider configuration should be an object"};
+            m_chunk_size     = parseSize(bulk, "chunk_size", m_chunk_size, sizeof(int32_t));
+            m_pipeline_depth = parseSize(bulk, "pipeline_depth", m_pipeline_depth, 1);
+        }
+        auto pool_config = json_config.contains("buffer_pool") ? json_config["buffer_pool"] : json::object();
+        if(!pool_config.is_object())
+            throw Exception{"\"buffer_pool\" field in Alpha provider configuration should be an object"};
+        std::vector<size_t> size_classes{64*1024, 1024*1024, 3*m_chunk_size};
+        if(pool_config.contains("size_classes")) {
+            auto& classes = pool_config["size_classes"];
+            if(!classes.is_array())
+                throw Exception{"\"size_classes\" field in Alpha provider configuration should be an array"};
+            size_classes.clear();
+            for(auto& c : classes) {
+                if(!c.is_number_unsigned() || c.get<size_t>() == 0)
+                    throw Exception{"\"size_classes\" field in Alpha provider configuration should contain positive integers"};
+                size_classes.push_back(c.get<size_t>());
+            }
+        }
+        auto capacity = parseSize(pool_config, "capacity", 16, 0);
+        auto use_hugepages = pool_config.value("hugepages", false);
+        auto preallocate   = pool_config.value("preallocate", false);
+        m_buffer_pool = std::make_unique<BufferPool>(
+            m_engine, std::move(size_classes), capacity, use_hugepages, preallocate);
+        auto cache_config = json_config.contains("endpoint_cache") ? json_config["endpoint_cache"] : json::object();
+        if(!cache_config.is_object())
+            throw Exception{"\"endpoint_cache\" field in Alpha provider configuration should be an object"};
+        m_endpoint_cache = std::make_unique<EndpointCache>(
+            m_engine, parseSize(cache_config, "capacity", 128, 0));
+        auto arrays_config = json_config.contains("arrays") ? json_config["arrays"] : json::object();
+        if(!arrays_config.is_object())
+            throw Exception{"\"arrays\" field in Alpha provider configuration should be an object"};
+        m_array_store = std::make_unique<ArrayStore>(
+            parseSize(arrays_config, "max_bytes", 1024*1024*1024, 0),
+            parseSize(arrays_config, "max_arrays", 1024, 0));
+        auto admission_config = json_config.contains("admission") ? json_config["admission"] : json::object();
+        if(!admission_config.is_object())
+            throw Exception{"\"admission\" field in Alpha provider configuration should be an object"};
+        auto admission_policy = AdmissionControl::Policy::Queue;
+        if(admission_config.contains("policy")) {
+            auto& policy = admission_config["policy"];
+            if(policy == "queue")       admission_policy = AdmissionControl::Policy::Queue;
+            else if(policy == "reject") admission_policy = AdmissionControl::Policy::Reject;
+            else throw Exception{"\"policy\" field in Alpha provider configuration should be \"queue\" or \"reject\""};
+        }
+        m_admission = std::make_unique<AdmissionControl>(
+            parseSize(admission_config, "max_inflight_bytes", 0, 0), admission_policy);
+        auto compute_config = json_config.contains("compute") ? json_config["compute"] : json::object();
+        if(!compute_config.is_object())
+            throw Exception{"\"compute\" field in Alpha provider configuration should be an object"};
+        m_grain_size = parseSize(compute_config, "grain_size", m_grain_size, 1);
+        m_max_tasks  = parseSize(compute_config, "max_tasks", m_max_tasks, 1);
+        m_compute_pool = m_pool;
+        if(compute_config.contains("pool")) {
+            if(!compute_config["pool"].is_string())
+                throw Exception{"\"pool\" field in Alpha provider configuration should be a string"};
+            m_compute_pool_name = compute_config["pool"].get<std::string>();
+            m_compute_pool = findPool(m_compute_pool_name);
+        }
+        m_tracer = std::make_unique<Tracer>(
+            std::format("alpha-provider-{}", get_provider_id()),
+            json_config.contains("tracing") ? json_config["tracing"] : json{});
+        auto coalescing_config = json_config.contains("coalescing") ? json_config["coalescing"] : json::object();
+        if(!coalescing_config.is_object())
+            throw Exception{"\"coalescing\" field in Alpha provider configuration should be an object"};
+        if(coalescing_config.contains("enabled") && !coalescing_config["enabled"].is_boolean())
+            throw Exception{"\"enabled\" field in Alpha provider configuration should be a boolean"};
+        m_coalescing = coalescing_config.value("enabled", false);
+        m_coalescing_window = std::chrono::microseconds{
+            parseSize(coalescing_config, "window_us", m_coalescing_window.count(), 0)};
+        m_coalescing_max_batch = parseSize(coalescing_config, "max_batch", m_coalescing_max_batch, 1);
+        // the ULT is started last so that no exception can be thrown after it runs
+        if(m_coalescing)
+            m_coalescing_ult = m_pool.make_thread([this]() { drainPendingSums(); });
     }
 
     ~ProviderImpl() {
         trace("Deregistering provider");
+        if(m_coalescing_ult) {
+            {
+                std::unique_lock<tl::mutex> lock{m_pending_sums_mutex};
+                m_stop_coalescing = true;
+            }
+            m_pending_sums_cv.notify_one();
+            (*m_coalescing_ult)->join();
+        }
     }
 
     std::string getConfig() const {
         auto config = json::object();
-        config["resource"] = json::object();
-        auto resource_config = json::object();
-        resource_config["type"] = m_backend->name();
-        resource_config["config"] = json::parse(m_backend->getConfig());
-        config["resource"] = std::move(resource_config);
+        config["resources"] = json::array();
+        {
+            std::shared_lock<std::shared_mutex> lock{m_resources_mutex};
+            std::vector<std::pair<ResourceID, std::shared_ptr<ResourceInterface>>> resources{
+                m_resources.begin(), m_resources.end()};
+            lock.unlock();
+            std::sort(resources.begin(), resources.end(),
+                      [](auto& a, auto& b) { return a.first < b.first; });
+            for(auto& [id, resource] : resources) {
+                config["resources"].push_back({
+                    {"id", id.value()},
+                    {"type", resource->name()},
+                    {"config", json::parse(resource->getConfig())}
+                });
+            }
+        }
+        config["bulk"] = json::object();
+        config["bulk"]["chunk_size"] = m_chunk_size;
+        config["bulk"]["pipeline_depth"] = m_pipeline_depth;
+        config["buffer_pool"] = m_buffer_pool->getConfig();
+        config["endpoint_cache"] = m_endpoint_cache->getConfig();
+        config["arrays"] = m_array_store->getConfig();
+        config["admission"] = m_admission->getConfig();
+        config["compute"] = json::object();
+        config["compute"]["grain_size"] = m_grain_size;
+        config["compute"]["max_tasks"] = m_max_tasks;
+        if(!m_compute_pool_name.empty())
+            config["compute"]["pool"] = m_compute_pool_name;
+        config["coalescing"] = json::object();
+        config["coalescing"]["enabled"] = m_coalescing;
+        config["coalescing"]["window_us"] = m_coalescing_window.count();
+        config["coalescing"]["max_batch"] = m_coalescing_max_batch;
+        config["tracing"] = m_tracer->getConfig();
+        config["rpc_pools"] = json::object();
+        for(auto& [rpc_name, pool_name] : m_rpc_pool_names) {
+            if(!pool_name.empty())
+                config["rpc_pools"][rpc_name] = pool_name;
+        }
         return config.dump();
     }
 
-    Result<bool> createResource(const std::string& resource_type,
-                                const json& resource_config) {
+    json getStats() const {
+        auto stats = m_stats.toJson();
+        stats["buffer_pool"] = m_buffer_pool->getStats();
+        stats["endpoint_cache"] = m_endpoint_cache->getStats();
+        stats["arrays"] = m_array_store->getStats();
+        stats["admission"] = m_admission->getStats();
+        return stats;
+    }
 
-        Result<bool> result;
+    std::string dumpTrace() const {
+        return m_tracer->dump();
+    }
 
+    tl::pool findPool(const std::string& name) const {
+        auto it = m_named_pools.find(name);
+        if(it != m_named_pools.end()) return it->second;
+        margo_pool_info info;
+        if(margo_find_pool_by_name(m_engine.get_margo_instance(), name.c_str(), &info) != HG_SUCCESS)
+            throw Exception{std::format("Could not find pool \"{}\"", name)};
+        return tl::pool{info.pool};
+    }
+
+    /**
+     * @brief Return the pool in which the specified RPC should be handled,
+     * according to the "rpc_pools" field of the configuration. This function
+     * is called before the body of the constructor, hence it does not throw
+     * on an invalid configuration (the constructor will).
+     */
+    tl::pool rpcPool(const std::string& rpc_name) {
+        m_rpc_pool_names[rpc_name] = "";
+        if(!m_config.is_object() || !m_config.contains("rpc_pools"))
+            return m_pool;
+        auto& rpc_pools = m_config["rpc_pools"];
+        if(!rpc_pools.is_object())
+            throw Exception{"\"rpc_pools\" field in Alpha provider configuration should be an object"};
+        if(!rpc_pools.contains(rpc_name))
+            return m_pool;
+        if(!rpc_pools[rpc_name].is_string())
+            throw Exception{"\"rpc_pools\" field in Alpha provider configuration should map RPC names to pool names"};
+        auto& pool_name = rpc_pools[rpc_name].get_ref<const std::string&>();
+        auto pool = findPool(pool_name);
+        m_rpc_pool_names[rpc_name] = pool_name;
+        return pool;
+    }
+
+    /**
+     * @brief Number of blocks into which parallelFor splits a range of n elements.
+     */
+    size_t numTasks(size_t n) const {
+        return std::max<size_t>(1, std::min(m_max_tasks, n / m_grain_size));
+    }
+
+    template<typename F>
+    void parallelFor(size_t n, F&& f) {
+        parallelForTasks(n, numTasks(n), [&f](size_t, size_t begin, size_t end) { f(begin, end); });
+    }
+
+    template<typename F>
+    void parallelForTasks(size_t n, size_t num_tasks, F&& f) {
+        // TUTORIAL
+        // ********
+        //
+        // This function splits the range [0, n) into num_tasks blocks (parallelFor uses
+        // up to m_max_tasks blocks of at least m_grain_size elements), and calls
+        // f(t, begin, end) on each block t. The first block is processed by the calling
+        // ULT, the others by ULTs created in m_compute_pool, so that a single request can
+        // use all the execution streams associated with that pool. The function returns
+        // once all the blocks have been processed, rethrowing the first exception raised
+        // by f, if any.
+        if(num_tasks == 1) {
+            f(size_t{0}, size_t{0}, n);
+            return;
+        }
+        forkJoin(m_compute_pool, num_tasks,
+                 [&](size_t t) { f(t, n*t/num_tasks, n*(t+1)/num_tasks); },
+                 []() {});
+    }
+
+    /**
+     * @brief Run the workers of a bulk RPC: worker(w) is called for each w in
+     * [0, num_workers), worker 0 in the calling ULT and the others in ULTs of
+     * m_bulk_pool. on_error() is called when a worker fails, e.g. to wake up
+     * the workers waiting on it. The first exception raised is rethrown once
+     * all the workers have completed.
+     */
+    template<typename W, typename E>
+    void runWorkers(size_t num_workers, W&& worker, E&& on_error) {
+        forkJoin(m_bulk_pool, num_workers, worker, on_error);
+    }
+
+    template<typename W>
+    void runWorkers(size_t num_workers, W&& worker) {
+        runWorkers(num_workers, worker, []() {});
+    }
+
+    /**
+     * @brief Call f(i) for each i in [0, count), f(0) in the calling ULT
+     * and the others in ULTs created in the pool, and wait for all of them.
+     * If f throws, or if a ULT cannot be created, on_error() is called and
+     * the first exception is rethrown, but only after all the ULTs already
+     * created have been joined, since they reference the caller's stack.
+     * Once a ULT could not be created, f(0) is not called.
+     */
+    template<typename F, typename E>
+    static void forkJoin(tl::pool& pool, size_t count, F&& f, E&& on_error) {
+        std::vector<std::exception_ptr> errors(count);
+        auto run = [&](size_t i) {
+            try {
+                f(i);
+            } catch(...) {
+                errors[i] = std::current_exception();
+                on_error();
+            }
+        };
+        std::vector<tl::managed<tl::thread>> ults;
+        ults.reserve(count - 1);
         try {
-            m_backend = ResourceFactory::createResource(resource_type, get_engine(), resource_config);
+            for(size_t i = 1; i < count; ++i)
+                ults.push_back(pool.make_thread([&run, i]() { run(i); }));
+        } catch(...) {
+            errors[0] = std::current_exception();
+            on_error();
+        }
+        if(!errors[0]) run(0);
+        for(auto& ult : ults) ult->join();
+        for(auto& e : errors) {
+            if(e) std::rethrow_exception(e);
+        }
+    }
+
+    static size_t parseSize(const json& section, const char* field,
+                            size_t default_value, size_t min_value) {
+        if(!section.contains(field)) return default_value;
+        auto& value = section[field];
+        if(!value.is_number_unsigned() || value.get<size_t>() < min_value)
+            throw Exception{std::format(
+                "\"{}\" field in Alpha provider configuration should be an integer >= {}",
+                field, min_value)};
+        return value.get<size_t>();
+    }
+
+    void createResourceFromConfig(const json& resource, std::optional<ResourceID> id) {
+        if(!resource.contains("type") || !resource["type"].is_string())
+            throw Exception{"\"type\" field not found in resource configuration for Alpha provider"};
+        auto& resource_type = resource["type"].get_ref<const std::string&>();
+        auto resource_config = resource.contains("config") ? resource["config"] : json::object();
+        createResource(resource_type, resource_config, id).check();
+    }
+
+    Result<ResourceID> createResource(const std::string& resource_type,
+                                      const json& resource_config,
+                                      std::optional<ResourceID> id = std::nullopt) {
+
+        Result<ResourceID> result;
+        std::shared_ptr<ResourceInterface> resource;
+
+        try {
+            resource = ResourceFactory::createResource(resource_type, get_engine(), resource_config);
         } catch(const std::exception& ex) {
             result.success() = false;
             result.error() = ex.what();
@@ -125,18 +591,113 @@ class ProviderImpl : public tl::provider<ProviderImpl> {
             return result;
         }
 
-        if(not m_backend) {
+        if(not resource) {
             result.success() = false;
             result.error() = "Unknown resource type "s + resource_type;
             error("Unknown resource type {}", resource_type);
             return result;
         }
 
-        trace("Successfully created resource of type {}", resource_type);
+        {
+            std::unique_lock<std::shared_mutex> lock{m_resources_mutex};
+            if(!id) {
+                while(m_resources.count(ResourceID{m_next_resource_id}))
+                    m_next_resource_id += 1;
+                id = ResourceID{m_next_resource_id++};
+            }
+            if(!m_resources.emplace(*id, std::move(resource)).second) {
+                result.success() = false;
+                result.error() = std::format("Resource {} already exists", id->value());
+                return result;
+            }
+        }
+        result.value() = *id;
+        trace("Successfully created resource {} of type {}", id->value(), resource_type);
         return result;
     }
 
-    void computeSumRPC(const tl::request& req,
+    /**
+     * @brief Return the resource with the given id, or nullptr.
+     */
+    std::shared_ptr<ResourceInterface> findResource(ResourceID id) const {
+        std::shared_lock<std::shared_mutex> lock{m_resources_mutex};
+        auto it = m_resources.find(id);
+        return it == m_resources.end() ? nullptr : it->second;
+    }
+
+    template<typename T>
+    static void resourceNotFound(Result<T>& result, ResourceID id) {
+        result.success() = false;
+        result.error() = std::format("Resource {} not found", id.value());
+    }
+
+    /**
+     * @brief Reject a request that admission control could not admit,
+     * with a retryable error so that the client can send it again.
+     */
+    template<typename T>
+    static void rejectOverloaded(Result<T>& result) {
+        result.success()   = false;
+        result.retryable() = true;
+        result.error()     = "Provider is overloaded, retry later";
+    }
+
+    void createResourceRPC(const tl::request& req,
+                           const std::string& resource_type,
+                           const std::string& resource_config) {
+        trace("Received createResource request");
+        Result<ResourceID> result;
+        tl::auto_respond<decltype(result)> response{req, result};
+        auto timer = m_stats.time(m_stats_ids.create_resource);
+        auto config = json::parse(resource_config, nullptr, false);
+        if(config.is_discarded()) {
+            result.success() = false;
+            result.error() = "Could not parse resource configuration";
+            return;
+        }
+        result = createResource(resource_type, config);
+    }
+
+    void destroyResourceRPC(const tl::request& req, ResourceID id) {
+        trace("Received destroyResource request");
+        Result<bool> result;
+        tl::auto_respond<decltype(result)> response{req, result};
+        auto timer = m_stats.time(m_stats_ids.destroy_resource);
+        // requests already holding the resource can still complete,
+        // it is freed when the last of them releases it. Its arrays are
+        // dropped after it is removed from m_resources, putArrayRPC checks
+        // that the resource still exists after storing an array.
+        std::shared_ptr<ResourceInterface> resource;
+        {
+            std::unique_lock<std::shared_mutex> lock{m_resources_mutex};
+            auto node = m_resources.extract(id);
+            if(node) resource = std::move(node.mapped());
+        }
+        if(!resource) {
+            resourceNotFound(result, id);
+            return;
+        }
+        m_array_store->dropResource(id);
+    }
+
+    void checkResourceRPC(const tl::request& req, ResourceID id) {
+        trace("Received checkResource request");
+        Result<bool> result;
+        tl::auto_respond<decltype(result)> response{req, result};
+        auto timer = m_stats.time(m_stats_ids.check_resource);
+        if(!findResource(id))
+            resourceNotFound(result, id);
+    }
+
+    void getStatsRPC(const tl::request& req) {
+        trace("Received getStats request");
+        Result<std::string> result;
+        tl::auto_respond<decltype(result)> response{req, result};
+        auto timer = m_stats.time(m_stats_ids.get_stats);
+        result.value() = getStats().dump();
+    }
+
+    void computeSumRPC(const tl::request& req, ResourceID id,
                        int32_t x, int32_t y) {
         // TUTORIAL
         // ********
@@ -144,24 +705,155 @@ class ProviderImpl : public tl::provider<ProviderImpl> {
         // This is a simple RPC function. The first argument must be a tl::request
         // that we can use to respond to the sender. tl::auto_respond uses the RAII
         // principle to call req.respond(result) in its destructor.
+        //
+        // If coalescing is enabled, the request is instead queued, and the response
+        // will be sent by drainPendingSums. This is possible because tl::request objects
+        // can be copied and used to respond after the RPC handler has returned.
+        //
+        // Note that for queued requests, the latency recorded in m_stats only covers
+        // the time needed to queue them. Otherwise the Timer and the Span are declared
+        // after the tl::auto_respond, so that they end before the response is sent and
+        // a client that received the response also sees the call in the statistics
+        // and in the trace.
         trace("Received computeSum request");
+        auto request  = m_tracer->sample();
+        auto resource = findResource(id);
+        if(resource && m_coalescing) {
+            auto timer = m_stats.time(m_stats_ids.compute_sum);
+            auto span  = m_tracer->span("computeSum", request);
+            {
+                std::unique_lock<tl::mutex> lock{m_pending_sums_mutex};
+                m_pending_sums.push_back(PendingSum{req, std::move(resource), x, y});
+            }
+            m_pending_sums_cv.notify_one();
+            return;
+        }
         Result<int32_t> result;
         tl::auto_respond<decltype(result)> response{req, result};
-        result = m_backend->computeSum(x, y);
+        auto timer = m_stats.time(m_stats_ids.compute_sum);
+        auto span  = m_tracer->span("computeSum", request);
+        if(!resource) {
+            resourceNotFound(result, id);
+            return;
+        }
+        result = resource->computeSum(x, y);
         trace("Successfully executed computeSum");
     }
 
-    void computeSumBulkRPC(const tl::request& req,
+    void drainPendingSums() {
+        std::vector<PendingSum> batch;
+        std::vector<int32_t> x, y, sums;
+        while(true) {
+            {
+                std::unique_lock<tl::mutex> lock{m_pending_sums_mutex};
+                m_pending_sums_cv.wait(lock, [this]() {
+                    return m_stop_coalescing || !m_pending_sums.empty();
+                });
+                if(m_pending_sums.empty()) return;
+                if(!m_stop_coalescing && m_pending_sums.size() < m_coalescing_max_batch) {
+                    // give other requests a chance to join the batch
+                    lock.unlock();
+                    tl::thread::sleep(m_engine, m_coalescing_window.count()/1000.0);
+                    lock.lock();
+                }
+                auto count = std::min(m_pending_sums.size(), m_coalescing_max_batch);
+                batch.assign(std::make_move_iterator(m_pending_sums.begin()),
+                             std::make_move_iterator(m_pending_sums.begin() + count));
+                m_pending_sums.erase(m_pending_sums.begin(), m_pending_sums.begin() + count);
+            }
+            trace("Processing a batch of {} computeSum requests", batch.size());
+            // requests are grouped by resource, each group is
+            // processed with one call to the resource's computeSums
+            std::stable_sort(batch.begin(), batch.end(),
+                [](const PendingSum& a, const PendingSum& b) { return a.resource < b.resource; });
+            for(size_t begin = 0, end = 0; begin < batch.size(); begin = end) {
+                while(end < batch.size() && batch[end].resource == batch[begin].resource) ++end;
+                const size_t count = end - begin;
+                x.resize(count);
+                y.resize(count);
+                sums.resize(count);
+                for(size_t i = 0; i < count; ++i) {
+                    x[i] = batch[begin + i].x;
+                    y[i] = batch[begin + i].y;
+                }
+                auto r = batch[begin].resource->computeSums(x, y, sums);
+                for(size_t i = 0; i < count; ++i) {
+                    Result<int32_t> result;
+                    if(r.success()) {
+                        result.value() = sums[i];
+                    } else {
+                        result.success() = false;
+                        result.error() = r.error();
+                    }
+                    try {
+                        batch[begin + i].req.respond(result);
+                    } catch(const std::exception& ex) {
+                        error("Could not respond to computeSum request: {}", ex.what());
+                    }
+                }
+            }
+            batch.clear();
+        }
+    }
+
+    void computeSumsInlineRPC(const tl::request& req, ResourceID id,
+                              std::vector<int32_t> x,
+                              std::vector<int32_t> y) {
+        // TUTORIAL
+        // ********
+        //
+        // For small arrays, the cost of registering memory and issuing RDMA operations
+        // exceeds the cost of copying the data. This RPC receives x and y as regular
+        // (serialized) arguments and sends the result back in its response.
+        trace("Received computeSumsInline request");
+        Result<std::vector<int32_t>> result;
+        tl::auto_respond<decltype(result)> response{req, result};
+        auto timer = m_stats.time(m_stats_ids.compute_sums_inline);
+        auto span  = m_tracer->span("computeSumsInline", m_tracer->sample());
+        auto resource = findResource(id);
+        if(!resource) {
+            resourceNotFound(result, id);
+            return;
+        }
+        if(x.size() != y.size()) {
+            result.success() = false;
+            result.error() = "Arrays must have the same size";
+            return;
+        }
+        result.value().resize(x.size());
+        auto r = resource->computeSums(x, y, result.value());
+        if(!r.success()) {
+            result.success() = false;
+            result.error() = std::move(r.error());
+            result.value().clear();
+        }
+        trace("Successfully executed computeSumsInline");
+    }
+
+    void computeSumBulkRPC(const tl::request& req, ResourceID id, uint8_t dtype,
                            BulkLocation remote_x, BulkLocation remote_y,
                            BulkLocation remote_result) {
         // TUTORIAL
         // ********
         //
         // This function relies on RDMA to transfer the x, y, and result values.
-        // m_engine.lookup() is used to lookup the addresses of these remote memory locations.
-        // Local copies are setup (local_x,y,result) and exposed using m_engine.expose.
-        // The << operator is then used to perform the appropriate transfers before and
-        // after m_backend->computeSum is called.
+        // m_endpoint_cache.lookup() is used to lookup the addresses of these remote memory
+        // locations, calling m_engine.lookup() only for addresses it has not seen recently.
+        // The arrays are then processed in chunks of m_chunk_size bytes by up to
+        // m_pipeline_depth workers, each running in its own ULT in the provider's pool.
+        // Each worker borrows a local buffer from m_buffer_pool, which holds buffers that
+        // have already been exposed with m_engine.expose. For each of its chunks, the worker
+        // uses the << operator to pull x and y, calls the resource's computeSums (possibly
+        // from multiple ULTs, see parallelFor), then uses the >> operator to push the result.
+        // While a worker computes, the others are waiting on their transfers, so pulls,
+        // computation, and pushes overlap, and the memory used by the server is bounded
+        // by 3*m_chunk_size*m_pipeline_depth. Before borrowing any buffer, the request
+        // acquires that many bytes from m_admission, which bounds the memory used by all
+        // the requests in flight; the request may then wait, or be rejected with a
+        // retryable error.
+        //
+        // The arrays may contain any DataType (sent as a single byte): the transfers only
+        // deal with bytes, and visitDataType selects the resource's computeSums overload.
         //
         // Note how the remote bulk handles must be bound to their endpoints using
         // .on(endpoint), and how the parenthesis operator is overloaded to select the
@@ -169,42 +861,659 @@ class ProviderImpl : public tl::provider<ProviderImpl> {
         trace("Received computeSumBulk request");
         Result<bool> result;
         tl::auto_respond<decltype(result)> response{req, result};
-        auto n = remote_x.size / sizeof(int32_t);
+        auto timer   = m_stats.time(m_stats_ids.compute_sum_bulk);
+        auto request = m_tracer->sample();
+        auto span    = m_tracer->span("computeSumBulk", request);
         try {
+            auto resource = findResource(id);
+            if(!resource)
+                throw Exception{std::format("Resource {} not found", id.value())};
+            if(remote_x.size != remote_y.size || remote_x.size != remote_result.size)
+                throw Exception{"BulkLocation arguments must have the same size"};
+            const auto   type      = static_cast<DataType>(dtype);
+            const size_t elem_size = sizeOf(type);
+            if(remote_x.size % elem_size != 0)
+                throw Exception{std::format("BulkLocation size should be a multiple of the size of {}",
+                                            toString(type))};
+            const size_t n = remote_x.size / elem_size;
+            if(n == 0) return;
 
-            auto x_endpoint      = m_engine.lookup(remote_x.address);
-            auto y_endpoint      = m_engine.lookup(remote_y.address);
-            auto result_endpoint = m_engine.lookup(remote_result.address);
+            auto lookup_span     = m_tracer->span("lookup", request);
+            auto x_endpoint      = m_endpoint_cache->lookup(remote_x.address);
+            auto y_endpoint      = remote_y.address == remote_x.address ? x_endpoint
+                                 : m_endpoint_cache->lookup(remote_y.address);
+            auto result_endpoint = remote_result.address == remote_x.address ? x_endpoint
+                                 : remote_result.address == remote_y.address ? y_endpoint
+                                 : m_endpoint_cache->lookup(remote_result.address);
+            lookup_span.end();
 
-            std::vector<int32_t> local_x(n);
-            std::vector<int32_t> local_y(n);
-            std::vector<int32_t> local_result(n);
+            const size_t chunk_elems = std::max<size_t>(m_chunk_size / elem_size, 1);
+            const size_t num_chunks  = (n + chunk_elems - 1) / chunk_elems;
+            const size_t num_workers = std::min(m_pipeline_depth, num_chunks);
+            const size_t buf_elems   = std::min(chunk_elems, n);
+            const size_t buf_size    = buf_elems*elem_size;
 
-            auto local_x_bulk = m_engine.expose(
-                {{(void*)local_x.data(), local_x.size()*sizeof(int32_t)}},
-                tl::bulk_mode::write_only);
-            auto local_y_bulk = m_engine.expose(
-                {{(void*)local_y.data(), local_y.size()*sizeof(int32_t)}},
-                tl::bulk_mode::write_only);
-            auto local_result_bulk = m_engine.expose(
-                {{(void*)local_result.data(), local_result.size()*sizeof(int32_t)}},
-                tl::bulk_mode::read_only);
+            auto admission_span = m_tracer->span("admission", request);
+            auto ticket = m_admission->acquire(3*buf_size*num_workers);
+            admission_span.end();
+            if(!ticket) {
+                rejectOverloaded(result);
+                return;
+            }
 
-            local_x_bulk << remote_x.bulk(remote_x.offset, remote_x.size).on(x_endpoint);
-            local_y_bulk << remote_y.bulk(remote_y.offset, remote_y.size).on(y_endpoint);
+            auto worker = [&](size_t first_chunk) {
+                auto borrow_span  = m_tracer->span("borrow", request);
+                auto lease        = m_buffer_pool->borrow(3*buf_size);
+                borrow_span.end();
+                auto& local_bulk  = lease.bulk();
+                auto local_data   = static_cast<char*>(lease.data());
+                for(size_t c = first_chunk; c < num_chunks; c += num_workers) {
+                    const size_t count  = std::min(chunk_elems, n - c*chunk_elems);
+                    const size_t offset = c*chunk_elems*elem_size;
+                    const size_t size   = count*elem_size;
+                    auto pull_span = m_tracer->span("pull", request);
+                    local_bulk(0, size)
+                        << remote_x.bulk(remote_x.offset + offset, size).on(x_endpoint);
+                    local_bulk(buf_size, size)
+                        << remote_y.bulk(remote_y.offset + offset, size).on(y_endpoint);
+                    m_stats.addBytesPulled(2*size);
+                    pull_span.end();
+                    auto compute_span = m_tracer->span("compute", request);
+                    visitDataType(type, [&](auto t) {
+                        using T = typename decltype(t)::type;
+                        auto local_x      = reinterpret_cast<T*>(local_data);
+                        auto local_y      = local_x + buf_elems;
+                        auto local_result = local_y + buf_elems;
+                        parallelFor(count, [&](size_t begin, size_t end) {
+                            resource->computeSums(
+                                std::span<const T>{local_x + begin, end - begin},
+                                std::span<const T>{local_y + begin, end - begin},
+                                std::span<T>{local_result + begin, end - begin}).check();
+                        });
+                    });
+                    compute_span.end();
+                    auto push_span = m_tracer->span("push", request);
+                    local_bulk(2*buf_size, size)
+                        >> remote_result.bulk(remote_result.offset + offset, size).on(result_endpoint);
+                    m_stats.addBytesPushed(size);
+                }
+            };
 
-            for(size_t i = 0; i < n; ++i) {
-                auto r = m_backend->computeSum(local_x[i], local_y[i]);
-                r.check();
-                local_result[i] = r.value();
+            runWorkers(num_workers, worker);
+        } catch(const std::exception& ex) {
+            result.error() = ex.what();
+            result.success() = false;
+        }
+        trace("Successfully executed computeSumBulk");
+    }
+
+    void reduceRPC(const tl::request& req, ResourceID id, uint8_t op, uint8_t dtype,
+                   const std::vector<BulkLocation>& inputs) {
+        // TUTORIAL
+        // ********
+        //
+        // This RPC reduces one array (or the element-wise sums of two arrays) into a
+        // single value, using the resource's reduce method. The arrays are pulled with
+        // the same pipeline as in computeSumBulkRPC, but nothing is pushed back: each
+        // parallelFor task computes a partial result for its part of a chunk, which is
+        // merged into the partial result of its worker, and the workers' partial results
+        // are merged into the value sent in the response.
+        //
+        // The response is a Result<int64_t> for integer arrays and a Result<double> for
+        // floating-point arrays (see ReduceAccumulator), so the Result is created once
+        // the DataType is known. An invalid DataType is reported with a Result<int64_t>,
+        // which the client can read whatever the type it expects, since the Result of
+        // an error does not contain a value.
+        trace("Received reduce request");
+        auto request = m_tracer->sample();
+        try {
+            visitDataType(static_cast<DataType>(dtype), [&](auto t) {
+                using T = typename decltype(t)::type;
+                Result<ReduceAccumulator<T>> result;
+                tl::auto_respond<decltype(result)> response{req, result};
+                auto timer = m_stats.time(m_stats_ids.reduce);
+                auto span  = m_tracer->span("reduce", request);
+                reduceBulk<T>(id, static_cast<ReduceOp>(op), inputs, request, result);
+            });
+        } catch(const std::exception& ex) {
+            Result<int64_t> result;
+            tl::auto_respond<decltype(result)> response{req, result};
+            auto timer = m_stats.time(m_stats_ids.reduce);
+            auto span  = m_tracer->span("reduce", request);
+            result.success() = false;
+            result.error() = ex.what();
+            return;
+        }
+        trace("Successfully executed reduce");
+    }
+
+    template<typename T>
+    void reduceBulk(ResourceID id, ReduceOp op, const std::vector<BulkLocation>& inputs,
+                    uint64_t request, Result<ReduceAccumulator<T>>& result) {
+        using Acc = ReduceAccumulator<T>;
+        try {
+            auto resource = findResource(id);
+            if(!resource)
+                throw Exception{std::format("Resource {} not found", id.value())};
+            if(inputs.empty() || inputs.size() > 2)
+                throw Exception{"reduce expects one or two BulkLocation arguments"};
+            const size_t num_inputs = inputs.size();
+            if(num_inputs == 2 && inputs[0].size != inputs[1].size)
+                throw Exception{"BulkLocation arguments must have the same size"};
+            if(inputs[0].size % sizeof(T) != 0)
+                throw Exception{std::format("BulkLocation size should be a multiple of the size of {}",
+                                            toString(dataTypeOf<T>))};
+            const size_t n = inputs[0].size / sizeof(T);
+            if(!checkReduceArguments(op, n, num_inputs == 2 ? n : 0, result)) return;
+            result.value() = identity<Acc>(op);
+            if(n == 0) return;
+
+            auto lookup_span = m_tracer->span("lookup", request);
+            std::vector<tl::endpoint> endpoints;
+            for(auto& input : inputs) {
+                endpoints.push_back(
+                    endpoints.empty() || input.address != inputs[0].address
+                    ? m_endpoint_cache->lookup(input.address) : endpoints[0]);
+            }
+            lookup_span.end();
+
+            const size_t chunk_elems = std::max<size_t>(m_chunk_size / sizeof(T), 1);
+            const size_t num_chunks  = (n + chunk_elems - 1) / chunk_elems;
+            const size_t num_workers = std::min(m_pipeline_depth, num_chunks);
+            const size_t buf_elems   = std::min(chunk_elems, n);
+            const size_t buf_size    = buf_elems*sizeof(T);
+
+            auto admission_span = m_tracer->span("admission", request);
+            auto ticket = m_admission->acquire(num_inputs*buf_size*num_workers);
+            admission_span.end();
+            if(!ticket) {
+                rejectOverloaded(result);
+                return;
             }
 
-            local_result_bulk >> remote_result.bulk(remote_result.offset, remote_result.size).on(result_endpoint);
+            std::vector<Acc> partials(num_workers, identity<Acc>(op));
+            auto worker = [&](size_t w) {
+                auto borrow_span  = m_tracer->span("borrow", request);
+                auto lease        = m_buffer_pool->borrow(num_inputs*buf_size);
+                borrow_span.end();
+                auto& local_bulk  = lease.bulk();
+                auto local_x      = reinterpret_cast<T*>(lease.data());
+                auto local_y      = num_inputs == 2 ? local_x + buf_elems : nullptr;
+                tl::mutex partial_mutex;
+                for(size_t c = w; c < num_chunks; c += num_workers) {
+                    const size_t count  = std::min(chunk_elems, n - c*chunk_elems);
+                    const size_t offset = c*chunk_elems*sizeof(T);
+                    const size_t size   = count*sizeof(T);
+                    auto pull_span = m_tracer->span("pull", request);
+                    for(size_t i = 0; i < num_inputs; ++i) {
+                        local_bulk(i*buf_size, size)
+                            << inputs[i].bulk(inputs[i].offset + offset, size).on(endpoints[i]);
+                    }
+                    m_stats.addBytesPulled(num_inputs*size);
+                    pull_span.end();
+                    auto compute_span = m_tracer->span("compute", request);
+                    parallelFor(count, [&](size_t begin, size_t end) {
+                        auto partial = resource->reduce(
+                            op, std::span<const T>{local_x + begin, end - begin},
+                            local_y ? std::span<const T>{local_y + begin, end - begin}
+                                    : std::span<const T>{}).valueOrThrow();
+                        std::unique_lock<tl::mutex> lock{partial_mutex};
+                        partials[w] = combine(op, partials[w], partial);
+                    });
+                }
+            };
+
+            runWorkers(num_workers, worker);
+
+            for(auto& partial : partials)
+                result.value() = combine(op, result.value(), partial);
         } catch(const std::exception& ex) {
             result.error() = ex.what();
             result.success() = false;
         }
-        trace("Successfully executed computeSumBulk");
+    }
+
+    void scanRPC(const tl::request& req, ResourceID id, uint8_t scan_type, uint8_t dtype,
+                 BulkLocation remote_x, BulkLocation remote_result) {
+        // TUTORIAL
+        // ********
+        //
+        // This RPC computes the inclusive or exclusive scan of an array. The array is
+        // pulled in chunks by the same pipeline of workers as in computeSumBulkRPC, and
+        // each chunk is scanned in place in the worker's buffer, then pushed back as soon
+        // as it is done, without waiting for the rest of the array.
+        //
+        // Scanning a chunk requires the total of all the preceding chunks (its carry).
+        // The chunks therefore form a carry chain: once a worker has pulled a chunk, it
+        // splits it into blocks and computes the total of each block in parallel (with
+        // the resource's reduce method), then waits for the carry of the previous chunk,
+        // and passes the carry of the next chunk along the chain. Only this addition is
+        // serialized: the blocks are then scanned in parallel (with the resource's scan
+        // method), each starting from the carry plus the totals of the preceding blocks,
+        // while the other workers pull, reduce, or push their own chunks.
+        //
+        // If a worker fails, the chain is marked as failed so that the workers waiting
+        // for a carry do not wait forever.
+        trace("Received scan request");
+        Result<bool> result;
+        tl::auto_respond<decltype(result)> response{req, result};
+        auto timer   = m_stats.time(m_stats_ids.scan);
+        auto request = m_tracer->sample();
+        auto span    = m_tracer->span("scan", request);
+        try {
+            auto resource = findResource(id);
+            if(!resource)
+                throw Exception{std::format("Resource {} not found", id.value())};
+            const auto type = static_cast<ScanType>(scan_type);
+            if(!checkScanArguments(type, remote_x.size, remote_result.size, result)) return;
+            const auto   data_type = static_cast<DataType>(dtype);
+            const size_t elem_size = sizeOf(data_type);
+            if(remote_x.size % elem_size != 0)
+                throw Exception{std::format("BulkLocation size should be a multiple of the size of {}",
+                                            toString(data_type))};
+            const size_t n = remote_x.size / elem_size;
+            if(n == 0) return;
+
+            auto lookup_span     = m_tracer->span("lookup", request);
+            auto x_endpoint      = m_endpoint_cache->lookup(remote_x.address);
+            auto result_endpoint = remote_result.address == remote_x.address ? x_endpoint
+                                 : m_endpoint_cache->lookup(remote_result.address);
+            lookup_span.end();
+
+            const size_t chunk_elems = std::max<size_t>(m_chunk_size / elem_size, 1);
+            const size_t num_chunks  = (n + chunk_elems - 1) / chunk_elems;
+            const size_t num_workers = std::min(m_pipeline_depth, num_chunks);
+            const size_t buf_size    = std::min(chunk_elems, n)*elem_size;
+
+            auto admission_span = m_tracer->span("admission", request);
+            auto ticket = m_admission->acquire(buf_size*num_workers);
+            admission_span.end();
+            if(!ticket) {
+                rejectOverloaded(result);
+                return;
+            }
+
+            visitDataType(data_type, [&](auto t) {
+                using T = typename decltype(t)::type;
+                struct {
+                    tl::mutex              mutex;
+                    tl::condition_variable cv;
+                    size_t                 next_chunk = 0;
+                    T                      carry{};
+                    bool                   failed = false;
+                } chain;
+
+                auto worker = [&](size_t w) {
+                    auto borrow_span = m_tracer->span("borrow", request);
+                    auto lease       = m_buffer_pool->borrow(buf_size);
+                    borrow_span.end();
+                    auto& local_bulk = lease.bulk();
+                    auto local_data  = reinterpret_cast<T*>(lease.data());
+                    for(size_t c = w; c < num_chunks; c += num_workers) {
+                        const size_t count  = std::min(chunk_elems, n - c*chunk_elems);
+                        const size_t offset = c*chunk_elems*elem_size;
+                        const size_t size   = count*elem_size;
+                        auto pull_span = m_tracer->span("pull", request);
+                        local_bulk(0, size)
+                            << remote_x.bulk(remote_x.offset + offset, size).on(x_endpoint);
+                        m_stats.addBytesPulled(size);
+                        pull_span.end();
+                        auto compute_span = m_tracer->span("compute", request);
+                        const size_t num_tasks = numTasks(count);
+                        std::vector<T> block_carries(num_tasks);
+                        parallelForTasks(count, num_tasks, [&](size_t b, size_t begin, size_t end) {
+                            block_carries[b] = static_cast<T>(resource->reduce(
+                                ReduceOp::Sum, std::span<const T>{local_data + begin, end - begin},
+                                std::span<const T>{}).valueOrThrow());
+                        });
+                        compute_span.end();
+                        auto carry_span = m_tracer->span("carry", request);
+                        T carry;
+                        {
+                            std::unique_lock<tl::mutex> lock{chain.mutex};
+                            chain.cv.wait(lock, [&]() { return chain.failed || chain.next_chunk == c; });
+                            if(chain.failed) return;
+                            carry = chain.carry;
+                            for(auto total : block_carries)
+                                chain.carry = scanAdd(chain.carry, total);
+                            chain.next_chunk += 1;
+                        }
+                        chain.cv.notify_all();
+                        carry_span.end();
+                        for(auto& block_carry : block_carries) {
+                            auto total  = block_carry;
+                            block_carry = carry;
+                            carry       = scanAdd(carry, total);
+                        }
+                        compute_span = m_tracer->span("compute", request);
+                        parallelForTasks(count, num_tasks, [&](size_t b, size_t begin, size_t end) {
+                            resource->scan(type, std::span<const T>{local_data + begin, end - begin},
+                                           std::span<T>{local_data + begin, end - begin},
+                                           block_carries[b]).check();
+                        });
+                        compute_span.end();
+                        auto push_span = m_tracer->span("push", request);
+                        local_bulk(0, size)
+                            >> remote_result.bulk(remote_result.offset + offset, size).on(result_endpoint);
+                        m_stats.addBytesPushed(size);
+                    }
+                };
+                auto fail_chain = [&]() {
+                    {
+                        std::unique_lock<tl::mutex> lock{chain.mutex};
+                        chain.failed = true;
+                    }
+                    chain.cv.notify_all();
+                };
+
+                runWorkers(num_workers, worker, fail_chain);
+            });
+        } catch(const std::exception& ex) {
+            result.error() = ex.what();
+            result.success() = false;
+        }
+        trace("Successfully executed scan");
+    }
+
+    void evaluateRPC(const tl::request& req, ResourceID id, uint8_t dtype,
+                     const Expression& expr, const std::vector<BulkLocation>& inputs,
+                     BulkLocation remote_result) {
+        // TUTORIAL
+        // ********
+        //
+        // This RPC evaluates an element-wise Expression over N input arrays (see
+        // Expression.hpp) with the resource's evaluate method, using the same pipeline
+        // of workers as computeSumBulkRPC: each worker pulls a chunk of every input,
+        // evaluates the expression over the chunk, and pushes the chunk of the result.
+        // Each input is thus transferred once and the result once, whatever the number
+        // of operations in the expression.
+        //
+        // Each worker needs N+1 buffers, so chunks are made smaller as N grows, keeping
+        // the memory used per worker the same as computeSumBulkRPC (3 chunks).
+        trace("Received evaluate request");
+        Result<bool> result;
+        tl::auto_respond<decltype(result)> response{req, result};
+        auto timer   = m_stats.time(m_stats_ids.evaluate);
+        auto request = m_tracer->sample();
+        auto span    = m_tracer->span("evaluate", request);
+        try {
+            auto resource = findResource(id);
+            if(!resource)
+                throw Exception{std::format("Resource {} not found", id.value())};
+            const auto   type      = static_cast<DataType>(dtype);
+            const size_t elem_size = sizeOf(type);
+            auto expr_error = expr.check(inputs.size(), type);
+            if(!expr_error.empty())
+                throw Exception{expr_error};
+            for(auto& input : inputs) {
+                if(input.size != remote_result.size)
+                    throw Exception{"BulkLocation arguments must have the same size"};
+            }
+            if(remote_result.size % elem_size != 0)
+                throw Exception{std::format("BulkLocation size should be a multiple of the size of {}",
+                                            toString(type))};
+            const size_t n = remote_result.size / elem_size;
+            if(n == 0) return;
+
+            auto lookup_span = m_tracer->span("lookup", request);
+            std::vector<tl::endpoint> endpoints;
+            for(auto& input : inputs) {
+                endpoints.push_back(
+                    endpoints.empty() || input.address != inputs[0].address
+                    ? m_endpoint_cache->lookup(input.address) : endpoints[0]);
+            }
+            auto result_endpoint = !inputs.empty() && remote_result.address == inputs[0].address
+                                 ? endpoints[0] : m_endpoint_cache->lookup(remote_result.address);
+            lookup_span.end();
+
+            const size_t num_buffers = inputs.size() + 1;
+            const size_t chunk_elems = std::max<size_t>(3*m_chunk_size / (num_buffers*elem_size), 1);
+            const size_t num_chunks  = (n + chunk_elems - 1) / chunk_elems;
+            const size_t num_workers = std::min(m_pipeline_depth, num_chunks);
+            const size_t buf_elems   = std::min(chunk_elems, n);
+            const size_t buf_size    = buf_elems*elem_size;
+
+            auto admission_span = m_tracer->span("admission", request);
+            auto ticket = m_admission->acquire(num_buffers*buf_size*num_workers);
+            admission_span.end();
+            if(!ticket) {
+                rejectOverloaded(result);
+                return;
+            }
+
+            auto worker = [&](size_t first_chunk) {
+                auto borrow_span  = m_tracer->span("borrow", request);
+                auto lease        = m_buffer_pool->borrow(num_buffers*buf_size);
+                borrow_span.end();
+                auto& local_bulk  = lease.bulk();
+                auto local_data   = static_cast<char*>(lease.data());
+                const size_t result_offset = inputs.size()*buf_size;
+                for(size_t c = first_chunk; c < num_chunks; c += num_workers) {
+                    const size_t count  = std::min(chunk_elems, n - c*chunk_elems);
+                    const size_t offset = c*chunk_elems*elem_size;
+                    const size_t size   = count*elem_size;
+                    auto pull_span = m_tracer->span("pull", request);
+                    for(size_t i = 0; i < inputs.size(); ++i) {
+                        local_bulk(i*buf_size, size)
+                            << inputs[i].bulk(inputs[i].offset + offset, size).on(endpoints[i]);
+                    }
+                    m_stats.addBytesPulled(inputs.size()*size);
+                    pull_span.end();
+                    auto compute_span = m_tracer->span("compute", request);
+                    visitDataType(type, [&](auto t) {
+                        using T = typename decltype(t)::type;
+                        auto local_inputs = reinterpret_cast<T*>(local_data);
+                        auto local_result = reinterpret_cast<T*>(local_data + result_offset);
+                        parallelFor(count, [&](size_t begin, size_t end) {
+                            std::span<const T> task_inputs[Expression::s_max_inputs];
+                            for(size_t i = 0; i < inputs.size(); ++i)
+                                task_inputs[i] = {local_inputs + i*buf_elems + begin, end - begin};
+                            resource->evaluate(
+                                expr, std::span<const std::span<const T>>{task_inputs, inputs.size()},
+                                std::span<T>{local_result + begin, end - begin}).check();
+                        });
+                    });
+                    compute_span.end();
+                    auto push_span = m_tracer->span("push", request);
+                    local_bulk(result_offset, size)
+                        >> remote_result.bulk(remote_result.offset + offset, size).on(result_endpoint);
+                    m_stats.addBytesPushed(size);
+                }
+            };
+
+            runWorkers(num_workers, worker);
+        } catch(const std::exception& ex) {
+            result.error() = ex.what();
+            result.success() = false;
+        }
+        trace("Successfully executed evaluate");
+    }
+
+    void putArrayRPC(const tl::request& req, ResourceID id, const std::string& name,
+                     uint8_t dtype, const BulkLocation& remote_data) {
+        // TUTORIAL
+        // ********
+        //
+        // This RPC pulls an array into a new buffer held by the ArrayStore, where later
+        // requests (e.g. computeSumsWithArrayRPC) find it by name instead of pulling it
+        // again. The array is pulled in a single transfer directly into its final buffer.
+        // The buffer counts against the admission control budget while it is being
+        // pulled, and against the store's limits once it is stored.
+        trace("Received putArray request");
+        Result<ArrayRef> result;
+        tl::auto_respond<decltype(result)> response{req, result};
+        auto timer   = m_stats.time(m_stats_ids.put_array);
+        auto request = m_tracer->sample();
+        auto span    = m_tracer->span("putArray", request);
+        try {
+            auto resource = findResource(id);
+            if(!resource)
+                throw Exception{std::format("Resource {} not found", id.value())};
+            if(name.empty())
+                throw Exception{"Array name should not be empty"};
+            const auto   type      = static_cast<DataType>(dtype);
+            const size_t elem_size = sizeOf(type);
+            if(remote_data.size == 0)
+                throw Exception{"Cannot store an empty array"};
+            if(remote_data.size % elem_size != 0)
+                throw Exception{std::format("BulkLocation size should be a multiple of the size of {}",
+                                            toString(type))};
+            if(!m_array_store->fits(remote_data.size))
+                throw Exception{std::format("Array of {} bytes exceeds the limits of the array store",
+                                            remote_data.size)};
+
+            auto admission_span = m_tracer->span("admission", request);
+            auto ticket = m_admission->acquire(remote_data.size);
+            admission_span.end();
+            if(!ticket) {
+                rejectOverloaded(result);
+                return;
+            }
+
+            auto lookup_span = m_tracer->span("lookup", request);
+            auto endpoint    = m_endpoint_cache->lookup(remote_data.address);
+            lookup_span.end();
+
+            auto array = std::make_shared<ArrayStore::Array>();
+            array->ref  = ArrayRef{name, 0, type, remote_data.size};
+            array->data.resize(remote_data.size);
+            auto pull_span  = m_tracer->span("pull", request);
+            auto local_bulk = m_engine.expose({{array->data.data(), array->data.size()}},
+                                              tl::bulk_mode::write_only);
+            local_bulk << remote_data.bulk(remote_data.offset, remote_data.size).on(endpoint);
+            m_stats.addBytesPulled(remote_data.size);
+            pull_span.end();
+            // the resource may have been destroyed (and its id reused) while the
+            // array was pulled or stored. destroyResourceRPC drops the resource's
+            // arrays after removing it, so checking after storing the array is
+            // enough to never leave it in the store. m_resources_mutex is not held
+            // while calling into the ArrayStore, whose tl::mutex may yield.
+            auto ref = m_array_store->put(id, std::move(array));
+            if(findResource(id) != resource) {
+                m_array_store->drop(id, ref);
+                throw Exception{std::format("Resource {} not found", id.value())};
+            }
+            result.value() = ref;
+        } catch(const std::exception& ex) {
+            result.error() = ex.what();
+            result.success() = false;
+        }
+        trace("Successfully executed putArray");
+    }
+
+    void dropArrayRPC(const tl::request& req, ResourceID id, const std::string& name) {
+        trace("Received dropArray request");
+        Result<bool> result;
+        tl::auto_respond<decltype(result)> response{req, result};
+        auto timer = m_stats.time(m_stats_ids.drop_array);
+        if(!findResource(id)) {
+            resourceNotFound(result, id);
+            return;
+        }
+        if(!m_array_store->drop(id, name)) {
+            result.success() = false;
+            result.error() = std::format("Array \"{}\" not found", name);
+        }
+    }
+
+    void computeSumsWithArrayRPC(const tl::request& req, ResourceID id, uint8_t dtype,
+                                 BulkLocation remote_x, const ArrayRef& y,
+                                 BulkLocation remote_result) {
+        // TUTORIAL
+        // ********
+        //
+        // This RPC is the same as computeSumBulkRPC, except that the y values come from
+        // an array stored by putArrayRPC: only the x values are pulled, and the resource
+        // reads the y values directly from the stored array. The request holds a reference
+        // to the array, so it can complete even if the array is replaced, dropped, or
+        // evicted in the meantime.
+        trace("Received computeSumsWithArray request");
+        Result<bool> result;
+        tl::auto_respond<decltype(result)> response{req, result};
+        auto timer   = m_stats.time(m_stats_ids.compute_sums_with_array);
+        auto request = m_tracer->sample();
+        auto span    = m_tracer->span("computeSumsWithArray", request);
+        try {
+            auto resource = findResource(id);
+            if(!resource)
+                throw Exception{std::format("Resource {} not found", id.value())};
+            auto stored = m_array_store->get(id, y);
+            if(!stored) {
+                throw Exception{y.version == 0
+                    ? std::format("Array \"{}\" not found", y.name)
+                    : std::format("Array \"{}\" (version {}) not found", y.name, y.version)};
+            }
+            const auto   type      = static_cast<DataType>(dtype);
+            const size_t elem_size = sizeOf(type);
+            if(stored->ref.type != type)
+                throw Exception{std::format("Array \"{}\" contains {} values, not {}",
+                                            y.name, toString(stored->ref.type), toString(type))};
+            if(remote_x.size != stored->data.size() || remote_x.size != remote_result.size)
+                throw Exception{"computeSums arguments must have the same size"};
+            const size_t n = remote_x.size / elem_size;
+
+            auto lookup_span     = m_tracer->span("lookup", request);
+            auto x_endpoint      = m_endpoint_cache->lookup(remote_x.address);
+            auto result_endpoint = remote_result.address == remote_x.address ? x_endpoint
+                                 : m_endpoint_cache->lookup(remote_result.address);
+            lookup_span.end();
+
+            const size_t chunk_elems = std::max<size_t>(m_chunk_size / elem_size, 1);
+            const size_t num_chunks  = (n + chunk_elems - 1) / chunk_elems;
+            const size_t num_workers = std::min(m_pipeline_depth, num_chunks);
+            const size_t buf_elems   = std::min(chunk_elems, n);
+            const size_t buf_size    = buf_elems*elem_size;
+
+            auto admission_span = m_tracer->span("admission", request);
+            auto ticket = m_admission->acquire(2*buf_size*num_workers);
+            admission_span.end();
+            if(!ticket) {
+                rejectOverloaded(result);
+                return;
+            }
+
+            auto worker = [&](size_t first_chunk) {
+                auto borrow_span  = m_tracer->span("borrow", request);
+                auto lease        = m_buffer_pool->borrow(2*buf_size);
+                borrow_span.end();
+                auto& local_bulk  = lease.bulk();
+                auto local_data   = static_cast<char*>(lease.data());
+                for(size_t c = first_chunk; c < num_chunks; c += num_workers) {
+                    const size_t count  = std::min(chunk_elems, n - c*chunk_elems);
+                    const size_t offset = c*chunk_elems*elem_size;
+                    const size_t size   = count*elem_size;
+                    auto pull_span = m_tracer->span("pull", request);
+                    local_bulk(0, size)
+                        << remote_x.bulk(remote_x.offset + offset, size).on(x_endpoint);
+                    m_stats.addBytesPulled(size);
+                    pull_span.end();
+                    auto compute_span = m_tracer->span("compute", request);
+                    visitDataType(type, [&](auto t) {
+                        using T = typename decltype(t)::type;
+                        auto local_x      = reinterpret_cast<T*>(local_data);
+                        auto local_result = local_x + buf_elems;
+                        auto stored_y     = reinterpret_cast<const T*>(stored->data.data() + offset);
+                        parallelFor(count, [&](size_t begin, size_t end) {
+                            resource->computeSums(
+                                std::span<const T>{local_x + begin, end - begin},
+                                std::span<const T>{stored_y + begin, end - begin},
+                                std::span<T>{local_result + begin, end - begin}).check();
+                        });
+                    });
+                    compute_span.end();
+                    auto push_span = m_tracer->span("push", request);
+                    local_bulk(buf_size, size)
+                        >> remote_result.bulk(remote_result.offset + offset, size).on(result_endpoint);
+                    m_stats.addBytesPushed(size);
+                }
+            };
+
+            runWorkers(num_workers, worker);
+        } catch(const std::exception& ex) {
+            result.error() = ex.what();
+            result.success() = false;
+        }
+        trace("Successfully executed computeSumsWithArray");
     }
 
 };
@@ -0,0 +1,125 @@
+/*
+ * (C) 2024 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#ifndef __ALPHA_REGISTRATION_CACHE_H
+#define __ALPHA_REGISTRATION_CACHE_H
+
+#include <thallium.hpp>
+
+#include <functional>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+namespace alpha {
+
+namespace tl = thallium;
+
+/**
+ * @brief The RegistrationCache keeps the bulk handles resulting from
+ * engine.expose() calls, indexed by (pointer, size, mode), so that
+ * operations called repeatedly on the same buffers do not register them
+ * again. The least recently used handle is evicted when the cache is full.
+ *
+ * Caution: the cache cannot know when the memory is freed. If a buffer is
+ * freed and another one is allocated at the same address with the same
+ * size, the stale registration will be used. Callers must clear the cache
+ * before freeing memory that may have been registered.
+ */
+class RegistrationCache {
+
+    struct Key {
+        const void*   ptr;
+        size_t        size;
+        tl::bulk_mode mode;
+
+        bool operator==(const Key& other) const {
+            return ptr == other.ptr && size == other.size && mode == other.mode;
+        }
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key& key) const {
+            auto h = std::hash<const void*>{}(key.ptr);
+            h ^= std::hash<size_t>{}(key.size) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+            h ^= static_cast<size_t>(key.mode) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+            return h;
+        }
+    };
+
+    using Entry = std::pair<Key, tl::bulk>;
+
+    public:
+
+    /**
+     * @brief Constructor.
+     *
+     * @param engine Thallium engine used to expose memory.
+     * @param capacity Maximum number of bulk handles kept in the cache.
+     */
+    RegistrationCache(const tl::engine& engine, size_t capacity)
+    : m_engine(engine)
+    , m_capacity(capacity) {}
+
+    RegistrationCache(const RegistrationCache&) = delete;
+
+    RegistrationCache& operator=(const RegistrationCache&) = delete;
+
+    /**
+     * @brief Maximum number of bulk handles kept in the cache.
+     */
+    size_t capacity() const {
+        return m_capacity;
+    }
+
+    /**
+     * @brief Return a bulk handle exposing the memory, registering
+     * it only if it is not already in the cache.
+     */
+    tl::bulk expose(const void* ptr, size_t size, tl::bulk_mode mode) {
+        Key key{ptr, size, mode};
+        {
+            std::unique_lock<tl::mutex> lock{m_mutex};
+            auto it = m_index.find(key);
+            if(it != m_index.end()) {
+                m_entries.splice(m_entries.begin(), m_entries, it->second);
+                return it->second->second;
+            }
+        }
+        auto bulk = m_engine.expose({{const_cast<void*>(ptr), size}}, mode);
+        if(m_capacity == 0) return bulk;
+        std::unique_lock<tl::mutex> lock{m_mutex};
+        if(m_index.find(key) != m_index.end())
+            return bulk;
+        m_entries.emplace_front(key, bulk);
+        m_index[key] = m_entries.begin();
+        if(m_entries.size() > m_capacity) {
+            m_index.erase(m_entries.back().first);
+            m_entries.pop_back();
+        }
+        return bulk;
+    }
+
+    /**
+     * @brief Remove all the entries from the cache.
+     */
+    void clear() {
+        std::unique_lock<tl::mutex> lock{m_mutex};
+        m_index.clear();
+        m_entries.clear();
+    }
+
+    private:
+
+    tl::engine       m_engine;
+    size_t           m_capacity;
+    tl::mutex        m_mutex;
+    std::list<Entry> m_entries;
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> m_index;
+};
+
+}
+
+#endif
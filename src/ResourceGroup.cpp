@@ -0,0 +1,112 @@
+/*
+ * (C) 2024 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#include "alpha/ResourceGroup.hpp"
+#include "alpha/Client.hpp"
+#include "alpha/Exception.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <numeric>
+
+namespace alpha {
+
+ResourceGroup::ResourceGroup(std::vector<ResourceHandle> handles,
+                             std::vector<double> weights)
+: m_handles(std::move(handles))
+, m_weights(std::move(weights)) {
+    for(auto& handle : m_handles)
+        if(!handle) throw Exception("Invalid alpha::ResourceHandle in ResourceGroup");
+    if(m_weights.empty())
+        m_weights.resize(m_handles.size(), 1.0);
+    if(m_weights.size() != m_handles.size())
+        throw Exception("ResourceGroup should have one weight per ResourceHandle");
+    for(auto w : m_weights)
+        if(!std::isfinite(w) || w <= 0.0)
+            throw Exception("ResourceGroup weights should be positive numbers");
+}
+
+std::vector<std::pair<size_t, size_t>> ResourceGroup::slices(size_t count) const {
+    // slice boundaries are rounded from the cumulative weights, so the slices
+    // always cover the whole array, and their sizes differ from the ideal
+    // ones by less than one element
+    std::vector<std::pair<size_t, size_t>> result;
+    result.reserve(m_handles.size());
+    auto total = std::accumulate(m_weights.begin(), m_weights.end(), 0.0);
+    double cumulative = 0.0;
+    size_t begin = 0;
+    for(size_t i = 0; i < m_weights.size(); ++i) {
+        cumulative += m_weights[i];
+        size_t end = i + 1 == m_weights.size() ? count
+                   : std::min(count, static_cast<size_t>(std::llround(count * (cumulative / total))));
+        end = std::max(end, begin);
+        result.emplace_back(begin, end - begin);
+        begin = end;
+    }
+    return result;
+}
+
+Future<void> ResourceGroup::computeSums(
+    std::span<const int32_t> x, std::span<const int32_t> y,
+    std::span<int32_t> result) const
+{
+    // TUTORIAL
+    // ********
+    //
+    // The spans are registered once with the Client of the first handle,
+    // then each resource receives BulkLocations covering its own slice of
+    // these registrations. The RegisteredBuffers are captured by the returned
+    // Future, so the memory stays registered until all the slices are done.
+
+    if(m_handles.empty()) throw Exception("Invalid alpha::ResourceGroup object");
+    if(x.size() != y.size() || y.size() != result.size())
+        throw Exception("span arguments must have the same size");
+    auto n = x.size();
+    if(n == 0) return Future<void>{[]() {}, []() { return true; }};
+    auto client = m_handles[0].client();
+    auto x_buffer = client.registerBuffer(
+        const_cast<int32_t*>(x.data()), n*sizeof(int32_t), thallium::bulk_mode::read_only);
+    auto y_buffer = client.registerBuffer(
+        const_cast<int32_t*>(y.data()), n*sizeof(int32_t), thallium::bulk_mode::read_only);
+    auto result_buffer = client.registerBuffer(
+        result.data(), n*sizeof(int32_t), thallium::bulk_mode::write_only);
+    auto future = std::make_shared<Future<void>>(
+        computeSums(x_buffer, y_buffer, result_buffer));
+    auto buffers = std::make_shared<std::vector<RegisteredBuffer>>(
+        std::vector<RegisteredBuffer>{x_buffer, y_buffer, result_buffer});
+    return Future<void>{
+        [future, buffers]() { future->wait(); },
+        [future]() { return future->completed(); }};
+}
+
+Future<void> ResourceGroup::computeSums(
+    const RegisteredBuffer& x, const RegisteredBuffer& y,
+    const RegisteredBuffer& result) const
+{
+    if(m_handles.empty()) throw Exception("Invalid alpha::ResourceGroup object");
+    if(x.size() != y.size() || y.size() != result.size())
+        throw Exception("RegisteredBuffer arguments must have the same size");
+    if(x.size() % sizeof(int32_t) != 0)
+        throw Exception("RegisteredBuffer size should be a multiple of sizeof(int32_t)");
+    auto futures = std::make_shared<std::vector<Future<void>>>();
+    auto slices = this->slices(x.size()/sizeof(int32_t));
+    for(size_t i = 0; i < m_handles.size(); ++i) {
+        auto [offset, count] = slices[i];
+        if(count == 0) continue;
+        futures->push_back(m_handles[i].computeSumsFromBulk(
+            x.location(offset*sizeof(int32_t), count*sizeof(int32_t)),
+            y.location(offset*sizeof(int32_t), count*sizeof(int32_t)),
+            result.location(offset*sizeof(int32_t), count*sizeof(int32_t))));
+    }
+    return Future<void>{
+        [futures]() { waitAll(*futures); },
+        [futures]() {
+            return std::all_of(futures->begin(), futures->end(),
+                               [](auto& f) { return f.completed(); });
+        }};
+}
+
+}
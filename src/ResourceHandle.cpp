@@ -12,9 +12,153 @@
 
 #include <thallium/serialization/stl/string.hpp>
 #include <thallium/serialization/stl/pair.hpp>
+#include <thallium/serialization/stl/vector.hpp>
+
+#include <chrono>
+#include <mutex>
+#include <random>
+#include <tuple>
 
 namespace alpha {
 
+/**
+ * @brief Wrap a Future so that the span ends when the Future is awaited.
+ * Used only for traced requests, to avoid the extra allocations otherwise.
+ */
+template<typename T>
+static Future<T> endSpanOnWait(Future<T>&& future, Tracer::Span&& span) {
+    auto f = std::make_shared<Future<T>>(std::move(future));
+    auto s = std::make_shared<Tracer::Span>(std::move(span));
+    return Future<T>{
+        [f, s]() -> T {
+            if constexpr (std::is_void_v<T>) {
+                f->wait();
+                s->end();
+            } else {
+                auto value = f->wait();
+                s->end();
+                return value;
+            }
+        },
+        [f]() { return f->completed(); }};
+}
+
+/**
+ * @brief Return a random duration between half and all of the backoff,
+ * so that clients rejected at the same time do not retry in lockstep.
+ */
+static std::chrono::microseconds jitter(std::chrono::microseconds backoff) {
+    thread_local std::minstd_rand rng{std::random_device{}()};
+    auto half = backoff.count()/2;
+    return std::chrono::microseconds{
+        half + std::uniform_int_distribution<int64_t>{0, backoff.count() - half}(rng)};
+}
+
+/**
+ * @brief State of a request sent by asyncWithRetries, shared by the copies
+ * of the Future. Both wait() and test() drive the same attempt loop, so a
+ * Future that is only polled (waitAny, co_await) also retries, and only
+ * completes once the last received Result is final.
+ */
+template<typename Wrapper, typename ... Args>
+struct RetryState {
+
+    using clock = std::chrono::steady_clock;
+
+    std::shared_ptr<ResourceHandleImpl>     impl;
+    thallium::remote_procedure&             rpc;
+    std::tuple<Args...>                     args;
+    thallium::mutex                         mutex;
+    std::optional<thallium::async_response> response; // attempt in flight
+    std::optional<Result<Wrapper>>          result;   // final Result
+    size_t                                  attempt = 1;
+    std::chrono::microseconds               backoff;
+    clock::time_point                       resend_at; // when nothing is in flight
+
+    RetryState(const std::shared_ptr<ResourceHandleImpl>& i,
+               thallium::remote_procedure& r, const Args&... a)
+    : impl(i), rpc(r), args(a...)
+    , backoff(i->m_client->m_retry.initial_backoff) {}
+
+    void send() {
+        response.emplace(std::apply(
+            [this](const auto&... a) { return rpc.on(impl->m_ph).async(a...); }, args));
+    }
+
+    /**
+     * @brief Process the Result of the attempt in flight: either it is
+     * final, or the next attempt is scheduled after a backoff.
+     * Must be called with the mutex held.
+     */
+    void receive() {
+        Result<Wrapper> r = response->wait();
+        response.reset();
+        const auto& policy = impl->m_client->m_retry;
+        if(r.success() || !r.retryable() || attempt >= policy.max_attempts) {
+            result.emplace(std::move(r));
+            return;
+        }
+        resend_at = clock::now() + jitter(backoff);
+        backoff   = std::min(2*backoff, policy.max_backoff);
+        ++attempt;
+    }
+
+    Result<Wrapper> wait() {
+        std::unique_lock<thallium::mutex> lock{mutex};
+        while(!result) {
+            if(response) {
+                receive();
+                continue;
+            }
+            auto now = clock::now();
+            if(now < resend_at) {
+                auto delay = std::chrono::duration<double, std::milli>(resend_at - now);
+                lock.unlock();
+                thallium::thread::sleep(impl->m_client->m_engine, delay.count());
+                lock.lock();
+                continue;
+            }
+            send();
+        }
+        return *result;
+    }
+
+    bool test() {
+        // another ULT holding the lock is already driving the attempts
+        std::unique_lock<thallium::mutex> lock{mutex, std::try_to_lock};
+        if(!lock.owns_lock()) return false;
+        if(result) return true;
+        if(response) {
+            if(!response->received()) return false;
+            receive();
+            if(result) return true;
+        }
+        if(clock::now() >= resend_at) send();
+        return false;
+    }
+};
+
+/**
+ * @brief Send a request with rpc.on(ph).async(args...) and return a Future
+ * that sends it again, after a backoff, when the provider rejects it with a
+ * retryable error (see RetryPolicy). The arguments are captured by the Future,
+ * which keeps the bulk handles they may contain alive until it completes.
+ */
+template<typename T, typename Wrapper = T, typename ... Args>
+static Future<T> asyncWithRetries(const std::shared_ptr<ResourceHandleImpl>& impl,
+                                  thallium::remote_procedure& rpc,
+                                  const Args&... args) {
+    auto state = std::make_shared<RetryState<Wrapper, Args...>>(impl, rpc, args...);
+    state->send();
+    return Future<T>{
+        [state]() -> T {
+            Result<Wrapper> r = state->wait();
+            if constexpr (std::is_void_v<T>) std::move(r).check();
+            else return std::move(r).valueOrThrow();
+        },
+        [state]() { return state->test(); }};
+}
+
 ResourceHandle::ResourceHandle() = default;
 
 ResourceHandle::ResourceHandle(const std::shared_ptr<ResourceHandleImpl>& impl)
@@ -38,6 +182,11 @@ Client ResourceHandle::client() const {
     return Client(self->m_client);
 }
 
+ResourceID ResourceHandle::resourceID() const {
+    if(not self) throw Exception("Invalid alpha::ResourceHandle object");
+    return self->m_resource_id;
+}
+
 Future<int32_t> ResourceHandle::computeSum(
         int32_t x, int32_t y) const
 {
@@ -47,11 +196,83 @@ Future<int32_t> ResourceHandle::computeSum(
     // This version of computeSum calls into the "async" method of the RPC.
     // The returned async_response is then moved into a Future for the caller
     // to wait on.
+    //
+    // If batching has been enabled, the call is instead added to the current
+    // SumBatch, which is sent when it reaches m_batch_max_items items, when
+    // m_batch_max_delay has elapsed since its first item was added, or when
+    // one of its futures is awaited, whichever comes first. The returned Future
+    // then extracts its value from the batch's response.
     if(not self) throw Exception("Invalid alpha::ResourceHandle object");
+    std::shared_ptr<SumBatch> batch;
+    size_t index = 0;
+    bool full = false;
+    {
+        std::unique_lock<thallium::mutex> lock{self->m_batch_mutex};
+        if(self->m_batch_max_items != 0) {
+            if(!self->m_current_batch) {
+                self->m_current_batch = std::make_shared<SumBatch>();
+                auto delay_ms = self->m_batch_max_delay.count()/1000.0;
+                self->m_client->m_engine.get_handler_pool().make_thread(
+                    [impl=self, batch=self->m_current_batch, delay_ms]() {
+                        thallium::thread::sleep(impl->m_client->m_engine, delay_ms);
+                        impl->flushBatch(batch);
+                    }, thallium::anonymous());
+            }
+            batch = self->m_current_batch;
+            index = batch->m_x.size();
+            batch->m_x.push_back(x);
+            batch->m_y.push_back(y);
+            full = batch->m_x.size() >= self->m_batch_max_items;
+        }
+    }
+    if(batch) {
+        if(full) self->flushBatch(batch);
+        return Future<int32_t>{
+            [impl=self, batch, index]() {
+                if(!batch->sent()) impl->flushBatch(batch);
+                return batch->get(index);
+            },
+            [batch]() { return batch->completed(); }};
+    }
     auto& rpc = self->m_client->m_compute_sum;
     auto& ph  = self->m_ph;
-    auto async_response = rpc.on(ph).async(x, y);
-    return Future<int32_t>{std::move(async_response)};
+    auto& tracer = self->m_client->m_tracer;
+    auto request = tracer.sample();
+    auto span = tracer.span("computeSum", request);
+    auto async_response = rpc.on(ph).async(self->m_resource_id, x, y);
+    if(request == 0) return Future<int32_t>{std::move(async_response)};
+    return endSpanOnWait(Future<int32_t>{std::move(async_response)}, std::move(span));
+}
+
+void ResourceHandle::enableBatching(
+        size_t max_items, std::chrono::microseconds max_delay) const
+{
+    if(not self) throw Exception("Invalid alpha::ResourceHandle object");
+    if(max_items == 0) throw Exception("max_items should be greater than 0");
+    std::unique_lock<thallium::mutex> lock{self->m_batch_mutex};
+    self->m_batch_max_items = max_items;
+    self->m_batch_max_delay = max_delay;
+}
+
+void ResourceHandle::disableBatching() const
+{
+    if(not self) throw Exception("Invalid alpha::ResourceHandle object");
+    {
+        std::unique_lock<thallium::mutex> lock{self->m_batch_mutex};
+        self->m_batch_max_items = 0;
+    }
+    flush();
+}
+
+void ResourceHandle::flush() const
+{
+    if(not self) throw Exception("Invalid alpha::ResourceHandle object");
+    std::shared_ptr<SumBatch> batch;
+    {
+        std::unique_lock<thallium::mutex> lock{self->m_batch_mutex};
+        batch = self->m_current_batch;
+    }
+    if(batch) self->flushBatch(batch);
 }
 
 Future<int32_t> ResourceHandle::computeSumWithTimeout(
@@ -66,13 +287,42 @@ Future<int32_t> ResourceHandle::computeSumWithTimeout(
     if(not self) throw Exception("Invalid alpha::ResourceHandle object");
     auto& rpc = self->m_client->m_compute_sum;
     auto& ph  = self->m_ph;
-    auto async_response = rpc.on(ph).timed_async(timeout, x, y);
+    auto async_response = rpc.on(ph).timed_async(timeout, self->m_resource_id, x, y);
     return Future<int32_t>{std::move(async_response)};
 }
 
 Future<void> ResourceHandle::computeSums(
     std::span<const int32_t> x, std::span<const int32_t> y,
     std::span<int32_t> result) const
+{
+    return computeSumsImpl(x, y, result);
+}
+
+Future<void> ResourceHandle::computeSums(
+    std::span<const int64_t> x, std::span<const int64_t> y,
+    std::span<int64_t> result) const
+{
+    return computeSumsImpl(x, y, result);
+}
+
+Future<void> ResourceHandle::computeSums(
+    std::span<const float> x, std::span<const float> y,
+    std::span<float> result) const
+{
+    return computeSumsImpl(x, y, result);
+}
+
+Future<void> ResourceHandle::computeSums(
+    std::span<const double> x, std::span<const double> y,
+    std::span<double> result) const
+{
+    return computeSumsImpl(x, y, result);
+}
+
+template<typename T>
+Future<void> ResourceHandle::computeSumsImpl(
+    std::span<const T> x, std::span<const T> y,
+    std::span<T> result) const
 {
     // TUTORIAL
     // ********
@@ -95,56 +345,528 @@ Future<void> ResourceHandle::computeSums(
     // The BulkLocation instances are then passed to computeSumsFromBulk.
     // Note that the content of the spans must remain valid until the returned future
     // completes, since the server will perform RDMA operations on them.
+    //
+    // If the Client was configured with a registration cache, the bulk handles are
+    // taken from (or added to) the cache instead of being created for each call.
+    //
+    // Small arrays (up to the client's inline threshold) are instead copied into
+    // the arguments of the alpha_compute_sums_inline RPC, and the result is copied
+    // from its response into the result span when the Future is awaited.
+    //
+    // If tracing is enabled and the request is sampled, the time spent exposing
+    // memory and the time until the returned Future is awaited are recorded.
+    //
+    // This function is a template on the element type T, instantiated by the
+    // computeSums overloads for each supported DataType. Only int32 arrays can
+    // be sent inline, since the alpha_compute_sums_inline RPC is also used by
+    // batched computeSum calls; arrays of other types always use RDMA.
 
     if(not self) throw Exception("Invalid alpha::ResourceHandle object");
     if(x.size() != y.size() || y.size() != result.size())
         throw Exception("span arguments must have the same size");
     auto n = x.size();
-    auto& engine = self->m_client->m_engine;
-    auto input_bulk = n == 0 ? thallium::bulk{} :
-        engine.expose({{(void*)(x.data()), n*sizeof(int32_t)},
-                       {(void*)(y.data()), n*sizeof(int32_t)}},
-                      thallium::bulk_mode::read_only);
+    if(n == 0) return Future<void>{[]() {}, []() { return true; }};
+    auto& client = *self->m_client;
+    auto request = client.m_tracer.sample();
+    if constexpr (std::is_same_v<T, int32_t>) {
+        if(n*sizeof(int32_t) <= client.m_inline_threshold) {
+            auto& rpc = client.m_compute_sums_inline;
+            auto& ph  = self->m_ph;
+            auto span = client.m_tracer.span("computeSumsInline", request);
+            auto future = std::make_shared<Future<std::vector<int32_t>>>(
+                rpc.on(ph).async(self->m_resource_id,
+                                 std::vector<int32_t>(x.begin(), x.end()),
+                                 std::vector<int32_t>(y.begin(), y.end())));
+            auto inline_future = Future<void>{
+                [future, result]() {
+                    auto values = future->wait();
+                    if(values.size() != result.size())
+                        throw Exception("Unexpected number of values in computeSums response");
+                    std::copy(values.begin(), values.end(), result.begin());
+                },
+                [future]() { return future->completed(); }};
+            if(request == 0) return inline_future;
+            return endSpanOnWait(std::move(inline_future), std::move(span));
+        }
+    }
+    auto expose_span = client.m_tracer.span("expose", request);
+    auto& engine = client.m_engine;
     auto engine_address = static_cast<std::string>(engine.self());
-    auto x_bulk_location = BulkLocation{
-        input_bulk,
-        engine_address,
-        0, sizeof(int32_t)*n
-    };
-    auto y_bulk_location = BulkLocation{
-        input_bulk,
-        engine_address,
-        sizeof(int32_t)*n, sizeof(int32_t)*x.size()
-    };
-    auto result_bulk_location = BulkLocation{
-        engine.expose({{(void*)(result.data()), n*sizeof(int32_t)}},
-                      thallium::bulk_mode::write_only),
-        engine_address,
-        0, sizeof(int32_t)*n
-    };
-    return computeSumsFromBulk(x_bulk_location, y_bulk_location, result_bulk_location);
+    BulkLocation x_bulk_location, y_bulk_location, result_bulk_location;
+    if(client.m_registration_cache.capacity() == 0) {
+        auto input_bulk =
+            engine.expose({{(void*)(x.data()), n*sizeof(T)},
+                           {(void*)(y.data()), n*sizeof(T)}},
+                          thallium::bulk_mode::read_only);
+        x_bulk_location = BulkLocation{
+            input_bulk,
+            engine_address,
+            0, sizeof(T)*n
+        };
+        y_bulk_location = BulkLocation{
+            input_bulk,
+            engine_address,
+            sizeof(T)*n, sizeof(T)*n
+        };
+        result_bulk_location = BulkLocation{
+            engine.expose({{(void*)(result.data()), n*sizeof(T)}},
+                          thallium::bulk_mode::write_only),
+            engine_address,
+            0, sizeof(T)*n
+        };
+    } else {
+        // with the registration cache enabled, each span is exposed
+        // separately so that it can be found again in the cache
+        auto& cache = client.m_registration_cache;
+        x_bulk_location = BulkLocation{
+            cache.expose(x.data(), n*sizeof(T), thallium::bulk_mode::read_only),
+            engine_address,
+            0, sizeof(T)*n
+        };
+        y_bulk_location = BulkLocation{
+            cache.expose(y.data(), n*sizeof(T), thallium::bulk_mode::read_only),
+            engine_address,
+            0, sizeof(T)*n
+        };
+        result_bulk_location = BulkLocation{
+            cache.expose(result.data(), n*sizeof(T), thallium::bulk_mode::write_only),
+            engine_address,
+            0, sizeof(T)*n
+        };
+    }
+    // the bulk handles are captured by the returned Future so that
+    // the memory stays registered until the operation completes
+    auto bulks = std::vector<thallium::bulk>{
+        x_bulk_location.bulk, y_bulk_location.bulk, result_bulk_location.bulk};
+    expose_span.end();
+    auto span = client.m_tracer.span("computeSumBulk", request);
+    auto future = std::make_shared<Future<void>>(
+        computeSumsFromBulk(x_bulk_location, y_bulk_location, result_bulk_location,
+                            dataTypeOf<T>));
+    auto bulk_future = Future<void>{
+        [future, bulks]() { future->wait(); },
+        [future]() { return future->completed(); }};
+    if(request == 0) return bulk_future;
+    return endSpanOnWait(std::move(bulk_future), std::move(span));
+}
+
+Future<void> ResourceHandle::computeSums(
+    const RegisteredBuffer& x, const RegisteredBuffer& y,
+    const RegisteredBuffer& result, DataType type) const
+{
+    // TUTORIAL
+    // ********
+    //
+    // This version of computeSums takes buffers that have already been
+    // registered with Client::registerBuffer, so it only needs to build
+    // BulkLocation instances for them before calling computeSumsFromBulk.
+    // It is up to the caller to keep the RegisteredBuffer instances alive
+    // until the returned Future completes.
+
+    if(not self) throw Exception("Invalid alpha::ResourceHandle object");
+    if(x.size() != y.size() || y.size() != result.size())
+        throw Exception("RegisteredBuffer arguments must have the same size");
+    if(x.size() % sizeOf(type) != 0)
+        throw Exception(std::string{"RegisteredBuffer size should be a multiple of the size of "}
+                        + toString(type));
+    return computeSumsFromBulk(x.location(), y.location(), result.location(), type);
 }
 
 Future<void> ResourceHandle::computeSumsFromBulk(
           const BulkLocation& x,
           const BulkLocation& y,
-          const BulkLocation& result) const
+          const BulkLocation& result,
+          DataType type) const
 {
     // TUTORIAL
     // ********
     //
     // This function simply invokes the compute_sum_bulk RPC in a non-blocking way,
-    // passing the x, y, and result BulkLocation objects. These objects have a serialize
-    // method so they can be passed as RPC arguments.
+    // passing the type of the elements and the x, y, and result BulkLocation objects.
+    // BulkLocation has a serialize method so it can be passed as RPC argument.
     //
     // Note that this method could be used to forward bulk handles that don't belong
     // to the calling process. Note also that the data referenced to by the BulkLocation
     // instances is not serialized. It will be transferred via RDMA by the server.
+    //
+    // A provider with admission control enabled may reject the request if it
+    // is overloaded. The error is then flagged as retryable, and the request
+    // is sent again after a backoff, following the client's RetryPolicy
+    // (see asyncWithRetries).
+
+    if(not self) throw Exception("Invalid alpha::ResourceHandle object");
+    auto dtype = static_cast<uint8_t>(type);
+    return asyncWithRetries<void, bool>(
+        self, self->m_client->m_compute_sum_bulk, self->m_resource_id, dtype, x, y, result);
+}
+
+Future<void> ResourceHandle::computeSums(
+    std::span<const int32_t> x, const ArrayRef& y, std::span<int32_t> result) const
+{
+    return computeSumsWithArrayImpl(x, y, result);
+}
+
+Future<void> ResourceHandle::computeSums(
+    std::span<const int64_t> x, const ArrayRef& y, std::span<int64_t> result) const
+{
+    return computeSumsWithArrayImpl(x, y, result);
+}
+
+Future<void> ResourceHandle::computeSums(
+    std::span<const float> x, const ArrayRef& y, std::span<float> result) const
+{
+    return computeSumsWithArrayImpl(x, y, result);
+}
+
+Future<void> ResourceHandle::computeSums(
+    std::span<const double> x, const ArrayRef& y, std::span<double> result) const
+{
+    return computeSumsWithArrayImpl(x, y, result);
+}
+
+template<typename T>
+Future<void> ResourceHandle::computeSumsWithArrayImpl(
+    std::span<const T> x, const ArrayRef& y, std::span<T> result) const
+{
+    // TUTORIAL
+    // ********
+    //
+    // This version of computeSums only exposes x and result, and sends the
+    // ArrayRef of y, which has a serialize method, to the
+    // alpha_compute_sums_with_array RPC. The type and size recorded in the
+    // ArrayRef are checked before exposing anything.
+
+    if(not self) throw Exception("Invalid alpha::ResourceHandle object");
+    if(y.type != dataTypeOf<T>)
+        throw Exception(std::string{"Array \""} + y.name + "\" contains " + toString(y.type)
+                        + " values, not " + toString(dataTypeOf<T>));
+    if(x.size() != result.size() || x.size()*sizeof(T) != y.size)
+        throw Exception("computeSums arguments must have the same size");
+    auto n = x.size();
+    if(n == 0) return Future<void>{[]() {}, []() { return true; }};
+    auto& client = *self->m_client;
+    auto request = client.m_tracer.sample();
+    auto expose_span = client.m_tracer.span("expose", request);
+    auto& engine = client.m_engine;
+    auto engine_address = static_cast<std::string>(engine.self());
+    auto expose = [&](const void* data, thallium::bulk_mode mode) {
+        auto bulk = client.m_registration_cache.capacity() == 0
+                  ? engine.expose({{const_cast<void*>(data), n*sizeof(T)}}, mode)
+                  : client.m_registration_cache.expose(data, n*sizeof(T), mode);
+        return BulkLocation{bulk, engine_address, 0, n*sizeof(T)};
+    };
+    auto x_bulk_location      = expose(x.data(), thallium::bulk_mode::read_only);
+    auto result_bulk_location = expose(result.data(), thallium::bulk_mode::write_only);
+    expose_span.end();
+    auto span = client.m_tracer.span("computeSumsWithArray", request);
+    auto future = asyncWithRetries<void, bool>(
+        self, client.m_compute_sums_with_array, self->m_resource_id,
+        static_cast<uint8_t>(dataTypeOf<T>), x_bulk_location, y, result_bulk_location);
+    if(request == 0) return future;
+    return endSpanOnWait(std::move(future), std::move(span));
+}
+
+Future<ArrayRef> ResourceHandle::putArray(
+    const std::string& name, std::span<const int32_t> data) const
+{
+    return putArrayImpl(name, data);
+}
 
+Future<ArrayRef> ResourceHandle::putArray(
+    const std::string& name, std::span<const int64_t> data) const
+{
+    return putArrayImpl(name, data);
+}
+
+Future<ArrayRef> ResourceHandle::putArray(
+    const std::string& name, std::span<const float> data) const
+{
+    return putArrayImpl(name, data);
+}
+
+Future<ArrayRef> ResourceHandle::putArray(
+    const std::string& name, std::span<const double> data) const
+{
+    return putArrayImpl(name, data);
+}
+
+template<typename T>
+Future<ArrayRef> ResourceHandle::putArrayImpl(
+    const std::string& name, std::span<const T> data) const
+{
+    // TUTORIAL
+    // ********
+    //
+    // putArray exposes the data (read only) and sends it to the alpha_put_array
+    // RPC along with its name and type. The provider pulls the data into memory
+    // it keeps, and responds with the ArrayRef identifying the new version of
+    // the array.
+
+    if(not self) throw Exception("Invalid alpha::ResourceHandle object");
+    if(name.empty()) throw Exception("Array name should not be empty");
+    if(data.empty()) throw Exception("Cannot store an empty array");
+    auto& client = *self->m_client;
+    auto& engine = client.m_engine;
+    auto size = data.size()*sizeof(T);
+    auto bulk = client.m_registration_cache.capacity() == 0
+              ? engine.expose({{const_cast<T*>(data.data()), size}}, thallium::bulk_mode::read_only)
+              : client.m_registration_cache.expose(data.data(), size, thallium::bulk_mode::read_only);
+    auto data_bulk_location = BulkLocation{bulk, static_cast<std::string>(engine.self()), 0, size};
+    return asyncWithRetries<ArrayRef>(
+        self, client.m_put_array, self->m_resource_id, name,
+        static_cast<uint8_t>(dataTypeOf<T>), data_bulk_location);
+}
+
+Future<void> ResourceHandle::dropArray(const std::string& name) const
+{
+    if(not self) throw Exception("Invalid alpha::ResourceHandle object");
+    auto& rpc = self->m_client->m_drop_array;
+    auto& ph  = self->m_ph;
+    auto async_response = rpc.on(ph).async(self->m_resource_id, name);
+    return Future<void>{std::move(async_response)};
+}
+
+Future<int64_t> ResourceHandle::reduce(
+    ReduceOp op, std::span<const int32_t> x, std::span<const int32_t> y) const
+{
+    return reduceImpl(op, x, y);
+}
+
+Future<int64_t> ResourceHandle::reduce(
+    ReduceOp op, std::span<const int64_t> x, std::span<const int64_t> y) const
+{
+    return reduceImpl(op, x, y);
+}
+
+Future<double> ResourceHandle::reduce(
+    ReduceOp op, std::span<const float> x, std::span<const float> y) const
+{
+    return reduceImpl(op, x, y);
+}
+
+Future<double> ResourceHandle::reduce(
+    ReduceOp op, std::span<const double> x, std::span<const double> y) const
+{
+    return reduceImpl(op, x, y);
+}
+
+template<typename T>
+Future<ReduceAccumulator<T>> ResourceHandle::reduceImpl(
+    ReduceOp op, std::span<const T> x, std::span<const T> y) const
+{
+    // TUTORIAL
+    // ********
+    //
+    // Contrary to computeSums, reduce only exposes its input spans (read only),
+    // since the provider sends the reduced value back in the RPC's response.
+    // The spans are exposed the same way as in computeSumsImpl, then passed to
+    // the alpha_reduce RPC as a vector of one or two BulkLocations.
+    //
+    // The arguments are checked before sending anything, so that the caller gets
+    // the same errors as the provider would report. The sum of an empty array is
+    // computed locally.
+
+    using Acc = ReduceAccumulator<T>;
+    if(not self) throw Exception("Invalid alpha::ResourceHandle object");
+    Result<Acc> checked;
+    if(!checkReduceArguments(op, x.size(), y.size(), checked)) checked.check();
+    auto n = x.size();
+    if(n == 0) return Future<Acc>{[]() { return Acc{0}; }, []() { return true; }};
+    auto& client = *self->m_client;
+    auto request = client.m_tracer.sample();
+    auto expose_span = client.m_tracer.span("expose", request);
+    auto& engine = client.m_engine;
+    auto engine_address = static_cast<std::string>(engine.self());
+    std::vector<BulkLocation> inputs;
+    if(client.m_registration_cache.capacity() == 0) {
+        std::vector<std::pair<void*, size_t>> segments{{(void*)(x.data()), n*sizeof(T)}};
+        if(!y.empty()) segments.emplace_back((void*)(y.data()), n*sizeof(T));
+        auto input_bulk = engine.expose(segments, thallium::bulk_mode::read_only);
+        for(size_t i = 0; i < segments.size(); ++i)
+            inputs.push_back(BulkLocation{input_bulk, engine_address, i*n*sizeof(T), n*sizeof(T)});
+    } else {
+        auto& cache = client.m_registration_cache;
+        inputs.push_back(BulkLocation{
+            cache.expose(x.data(), n*sizeof(T), thallium::bulk_mode::read_only),
+            engine_address, 0, n*sizeof(T)});
+        if(!y.empty()) {
+            inputs.push_back(BulkLocation{
+                cache.expose(y.data(), n*sizeof(T), thallium::bulk_mode::read_only),
+                engine_address, 0, n*sizeof(T)});
+        }
+    }
+    expose_span.end();
+    auto span = client.m_tracer.span("reduce", request);
+    auto future = asyncWithRetries<Acc>(
+        self, client.m_reduce, self->m_resource_id,
+        static_cast<uint8_t>(op), static_cast<uint8_t>(dataTypeOf<T>), inputs);
+    if(request == 0) return future;
+    return endSpanOnWait(std::move(future), std::move(span));
+}
+
+Future<void> ResourceHandle::scan(
+    ScanType type, std::span<const int32_t> x, std::span<int32_t> result) const
+{
+    return scanImpl(type, x, result);
+}
+
+Future<void> ResourceHandle::scan(
+    ScanType type, std::span<const int64_t> x, std::span<int64_t> result) const
+{
+    return scanImpl(type, x, result);
+}
+
+Future<void> ResourceHandle::scan(
+    ScanType type, std::span<const float> x, std::span<float> result) const
+{
+    return scanImpl(type, x, result);
+}
+
+Future<void> ResourceHandle::scan(
+    ScanType type, std::span<const double> x, std::span<double> result) const
+{
+    return scanImpl(type, x, result);
+}
+
+template<typename T>
+Future<void> ResourceHandle::scanImpl(
+    ScanType type, std::span<const T> x, std::span<T> result) const
+{
+    // TUTORIAL
+    // ********
+    //
+    // scan exposes x (read only) and result (write only) like computeSumsImpl,
+    // and sends them to the alpha_scan RPC along with the type of scan and of
+    // the elements. The provider pushes the running totals into result as it
+    // computes them (see ProviderImpl::scanRPC).
+
+    if(not self) throw Exception("Invalid alpha::ResourceHandle object");
+    Result<bool> checked;
+    if(!checkScanArguments(type, x.size(), result.size(), checked)) checked.check();
+    auto n = x.size();
+    if(n == 0) return Future<void>{[]() {}, []() { return true; }};
+    auto& client = *self->m_client;
+    auto request = client.m_tracer.sample();
+    auto expose_span = client.m_tracer.span("expose", request);
+    auto& engine = client.m_engine;
+    auto engine_address = static_cast<std::string>(engine.self());
+    auto expose = [&](const void* data, thallium::bulk_mode mode) {
+        auto bulk = client.m_registration_cache.capacity() == 0
+                  ? engine.expose({{const_cast<void*>(data), n*sizeof(T)}}, mode)
+                  : client.m_registration_cache.expose(data, n*sizeof(T), mode);
+        return BulkLocation{bulk, engine_address, 0, n*sizeof(T)};
+    };
+    auto x_bulk_location      = expose(x.data(), thallium::bulk_mode::read_only);
+    auto result_bulk_location = expose(result.data(), thallium::bulk_mode::write_only);
+    expose_span.end();
+    auto span = client.m_tracer.span("scan", request);
+    auto future = asyncWithRetries<void, bool>(
+        self, client.m_scan, self->m_resource_id, static_cast<uint8_t>(type),
+        static_cast<uint8_t>(dataTypeOf<T>), x_bulk_location, result_bulk_location);
+    if(request == 0) return future;
+    return endSpanOnWait(std::move(future), std::move(span));
+}
+
+Future<void> ResourceHandle::evaluate(
+    const Expression& expr, const std::vector<std::span<const int32_t>>& inputs,
+    std::span<int32_t> result) const
+{
+    return evaluateImpl(expr, inputs, result);
+}
+
+Future<void> ResourceHandle::evaluate(
+    const Expression& expr, const std::vector<std::span<const int64_t>>& inputs,
+    std::span<int64_t> result) const
+{
+    return evaluateImpl(expr, inputs, result);
+}
+
+Future<void> ResourceHandle::evaluate(
+    const Expression& expr, const std::vector<std::span<const float>>& inputs,
+    std::span<float> result) const
+{
+    return evaluateImpl(expr, inputs, result);
+}
+
+Future<void> ResourceHandle::evaluate(
+    const Expression& expr, const std::vector<std::span<const double>>& inputs,
+    std::span<double> result) const
+{
+    return evaluateImpl(expr, inputs, result);
+}
+
+template<typename T>
+Future<void> ResourceHandle::evaluateImpl(
+    const Expression& expr, const std::vector<std::span<const T>>& inputs,
+    std::span<T> result) const
+{
+    // TUTORIAL
+    // ********
+    //
+    // evaluate exposes each input (read only) and the result (write only) like
+    // scanImpl, and sends the Expression, which has a serialize method, to the
+    // alpha_evaluate RPC along with the BulkLocations. The expression is checked
+    // before exposing anything, so that the caller gets the same errors as the
+    // provider would report.
+
+    if(not self) throw Exception("Invalid alpha::ResourceHandle object");
+    Result<bool> checked;
+    if(!checkExpressionArguments(expr, std::span<const std::span<const T>>{inputs}, result, checked))
+        checked.check();
+    auto n = result.size();
+    if(n == 0) return Future<void>{[]() {}, []() { return true; }};
+    auto& client = *self->m_client;
+    auto request = client.m_tracer.sample();
+    auto expose_span = client.m_tracer.span("expose", request);
+    auto& engine = client.m_engine;
+    auto engine_address = static_cast<std::string>(engine.self());
+    auto expose = [&](const void* data, thallium::bulk_mode mode) {
+        auto bulk = client.m_registration_cache.capacity() == 0
+                  ? engine.expose({{const_cast<void*>(data), n*sizeof(T)}}, mode)
+                  : client.m_registration_cache.expose(data, n*sizeof(T), mode);
+        return BulkLocation{bulk, engine_address, 0, n*sizeof(T)};
+    };
+    std::vector<BulkLocation> input_bulk_locations;
+    input_bulk_locations.reserve(inputs.size());
+    for(auto& input : inputs)
+        input_bulk_locations.push_back(expose(input.data(), thallium::bulk_mode::read_only));
+    auto result_bulk_location = expose(result.data(), thallium::bulk_mode::write_only);
+    expose_span.end();
+    auto span = client.m_tracer.span("evaluate", request);
+    auto future = asyncWithRetries<void, bool>(
+        self, client.m_evaluate, self->m_resource_id, static_cast<uint8_t>(dataTypeOf<T>),
+        expr, input_bulk_locations, result_bulk_location);
+    if(request == 0) return future;
+    return endSpanOnWait(std::move(future), std::move(span));
+}
+
+Future<void> ResourceHandle::evaluateFromBulk(
+          const Expression& expr,
+          const std::vector<BulkLocation>& inputs,
+          const BulkLocation& result,
+          DataType type) const
+{
+    if(not self) throw Exception("Invalid alpha::ResourceHandle object");
+    auto dtype = static_cast<uint8_t>(type);
+    return asyncWithRetries<void, bool>(
+        self, self->m_client->m_evaluate, self->m_resource_id, dtype, expr, inputs, result);
+}
+
+Future<std::string> ResourceHandle::getStats() const
+{
+    if(not self) throw Exception("Invalid alpha::ResourceHandle object");
+    auto& rpc = self->m_client->m_get_stats;
+    auto& ph  = self->m_ph;
+    auto async_response = rpc.on(ph).async();
+    return Future<std::string>{std::move(async_response)};
+}
+
+Future<void> ResourceHandle::destroy() const
+{
     if(not self) throw Exception("Invalid alpha::ResourceHandle object");
-    auto& rpc = self->m_client->m_compute_sum_bulk;
+    auto& rpc = self->m_client->m_destroy_resource;
     auto& ph  = self->m_ph;
-    auto async_response = rpc.on(ph).async(x, y, result);
+    auto async_response = rpc.on(ph).async(self->m_resource_id);
     return Future<void>{std::move(async_response)};
 }
 
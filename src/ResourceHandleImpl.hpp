@@ -6,23 +6,120 @@
 #ifndef __ALPHA_RESOURCE_HANDLE_IMPL_H
 #define __ALPHA_RESOURCE_HANDLE_IMPL_H
 
+#include "alpha/Future.hpp"
+#include "alpha/ResourceID.hpp"
 #include "ClientImpl.hpp"
 
+#include <chrono>
+#include <exception>
+#include <optional>
+
 namespace alpha {
 
+/**
+ * @brief A SumBatch accumulates the arguments of computeSum calls
+ * made while batching is enabled, and sends them all at once using
+ * the alpha_compute_sums_inline RPC.
+ */
+class SumBatch {
+
+    public:
+
+    std::vector<int32_t> m_x;
+    std::vector<int32_t> m_y;
+
+    /**
+     * @brief Send the batch. Only the first call has an effect.
+     */
+    void send(tl::remote_procedure& rpc, const tl::provider_handle& ph, ResourceID id) {
+        std::unique_lock<tl::mutex> lock{m_mutex};
+        if(m_future) return;
+        m_future.emplace(rpc.on(ph).async(id, m_x, m_y));
+    }
+
+    /**
+     * @brief Whether the batch has been sent.
+     */
+    bool sent() {
+        std::unique_lock<tl::mutex> lock{m_mutex};
+        return m_future.has_value();
+    }
+
+    /**
+     * @brief Whether the response for the batch has been received.
+     */
+    bool completed() {
+        std::unique_lock<tl::mutex> lock{m_mutex};
+        return m_values || m_error || (m_future && m_future->completed());
+    }
+
+    /**
+     * @brief Wait for the response (the batch must have been sent)
+     * and return the value at the specified index.
+     */
+    int32_t get(size_t index) {
+        std::unique_lock<tl::mutex> lock{m_mutex};
+        if(!m_values && !m_error) {
+            try {
+                m_values = m_future->wait();
+                if(m_values->size() != m_x.size())
+                    throw Exception("Unexpected number of values in computeSum batch response");
+            } catch(...) {
+                m_error = std::current_exception();
+            }
+        }
+        if(m_error) std::rethrow_exception(m_error);
+        return (*m_values)[index];
+    }
+
+    private:
+
+    tl::mutex                                   m_mutex;
+    std::optional<Future<std::vector<int32_t>>> m_future;
+    std::optional<std::vector<int32_t>>         m_values;
+    std::exception_ptr                          m_error;
+};
+
 class ResourceHandleImpl {
 
     public:
 
     std::shared_ptr<ClientImpl> m_client;
     tl::provider_handle         m_ph;
+    ResourceID                  m_resource_id;
+
+    // Batching of computeSum calls (disabled if m_batch_max_items is 0)
+    tl::mutex                 m_batch_mutex;
+    size_t                    m_batch_max_items = 0;
+    std::chrono::microseconds m_batch_max_delay{0};
+    std::shared_ptr<SumBatch> m_current_batch;
 
     ResourceHandleImpl() = default;
 
     ResourceHandleImpl(std::shared_ptr<ClientImpl> client,
-                       tl::provider_handle&& ph)
+                       tl::provider_handle&& ph,
+                       ResourceID resource_id)
     : m_client(std::move(client))
-    , m_ph(std::move(ph)) {}
+    , m_ph(std::move(ph))
+    , m_resource_id(resource_id) {}
+
+    ~ResourceHandleImpl() {
+        // batches that have not been sent are sent so that
+        // futures referring to them can still complete
+        if(m_current_batch) m_current_batch->send(m_client->m_compute_sums_inline, m_ph, m_resource_id);
+    }
+
+    /**
+     * @brief Detach the batch from the handle if it is the current
+     * one, then send it.
+     */
+    void flushBatch(const std::shared_ptr<SumBatch>& batch) {
+        {
+            std::unique_lock<tl::mutex> lock{m_batch_mutex};
+            if(m_current_batch == batch) m_current_batch.reset();
+        }
+        batch->send(m_client->m_compute_sums_inline, m_ph, m_resource_id);
+    }
 };
 
 }
@@ -0,0 +1,196 @@
+/*
+ * (C) 2024 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#ifndef __ALPHA_STATISTICS_H
+#define __ALPHA_STATISTICS_H
+
+#include <alpha/Exception.hpp>
+
+#include <thallium.hpp>
+#include <nlohmann/json.hpp>
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace alpha {
+
+namespace tl = thallium;
+
+/**
+ * @brief The Statistics class holds the performance counters of a
+ * provider: per-RPC call counts and latency histograms, number of bytes
+ * pulled and pushed with RDMA, and number of requests in flight.
+ *
+ * Counters are spread across slots indexed by the rank of the calling
+ * execution stream, so that ULTs running in different execution streams
+ * do not contend on the same cache lines. Updates are relaxed atomic
+ * increments; the slots are only summed up when the statistics are read.
+ *
+ * Latencies are recorded in a histogram with power-of-two buckets:
+ * bucket b counts the calls that took less than 2^b nanoseconds (and at
+ * least 2^(b-1)). The last bucket also counts all the slower calls.
+ */
+class Statistics {
+
+    using json = nlohmann::json;
+
+    public:
+
+    static constexpr size_t s_max_rpcs    = 32;
+    static constexpr size_t s_num_buckets = 40;
+    static constexpr size_t s_num_slots   = 16;
+
+    /**
+     * @brief RAII object measuring the duration of an RPC handler.
+     * RPC handlers declare it after their tl::auto_respond, so that the
+     * call is recorded before the response is sent.
+     */
+    class Timer {
+
+        friend class Statistics;
+
+        Statistics* m_stats;
+        size_t      m_rpc;
+        std::chrono::steady_clock::time_point m_start;
+
+        Timer(Statistics* stats, size_t rpc)
+        : m_stats(stats)
+        , m_rpc(rpc)
+        , m_start(std::chrono::steady_clock::now()) {
+            m_stats->slot().in_flight.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        public:
+
+        Timer(const Timer&) = delete;
+
+        Timer& operator=(const Timer&) = delete;
+
+        ~Timer() {
+            auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - m_start).count();
+            // the ULT may have moved to another execution stream,
+            // in_flight is only meaningful summed over all the slots
+            auto& slot = m_stats->slot();
+            auto& rpc  = slot.rpcs[m_rpc];
+            rpc.calls.fetch_add(1, std::memory_order_relaxed);
+            rpc.total_ns.fetch_add(elapsed, std::memory_order_relaxed);
+            rpc.buckets[bucketOf(elapsed)].fetch_add(1, std::memory_order_relaxed);
+            slot.in_flight.fetch_sub(1, std::memory_order_relaxed);
+        }
+    };
+
+    Statistics() = default;
+
+    Statistics(const Statistics&) = delete;
+
+    Statistics& operator=(const Statistics&) = delete;
+
+    /**
+     * @brief Register an RPC name and return the index to use
+     * with time(). Must be called before any RPC is received.
+     */
+    size_t registerRPC(const std::string& name) {
+        if(m_rpc_names.size() == s_max_rpcs)
+            throw Exception{"Too many RPCs registered in alpha::Statistics"};
+        m_rpc_names.push_back(name);
+        return m_rpc_names.size() - 1;
+    }
+
+    /**
+     * @brief Start measuring a call to the specified RPC.
+     * The call is recorded when the returned Timer is destroyed.
+     */
+    Timer time(size_t rpc) {
+        return Timer{this, rpc};
+    }
+
+    void addBytesPulled(size_t bytes) {
+        slot().bytes_pulled.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    void addBytesPushed(size_t bytes) {
+        slot().bytes_pushed.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Sum up the slots and return the statistics as JSON.
+     */
+    json toJson() const {
+        uint64_t bytes_pulled = 0, bytes_pushed = 0;
+        int64_t in_flight = 0;
+        for(auto& slot : m_slots) {
+            bytes_pulled += slot.bytes_pulled.load(std::memory_order_relaxed);
+            bytes_pushed += slot.bytes_pushed.load(std::memory_order_relaxed);
+            in_flight    += slot.in_flight.load(std::memory_order_relaxed);
+        }
+        auto rpcs = json::object();
+        for(size_t i = 0; i < m_rpc_names.size(); ++i) {
+            uint64_t calls = 0, total_ns = 0;
+            std::array<uint64_t, s_num_buckets> buckets{};
+            for(auto& slot : m_slots) {
+                auto& rpc = slot.rpcs[i];
+                calls    += rpc.calls.load(std::memory_order_relaxed);
+                total_ns += rpc.total_ns.load(std::memory_order_relaxed);
+                for(size_t b = 0; b < s_num_buckets; ++b)
+                    buckets[b] += rpc.buckets[b].load(std::memory_order_relaxed);
+            }
+            auto histogram = json::array();
+            for(size_t b = 0; b < s_num_buckets; ++b) {
+                if(buckets[b] == 0) continue;
+                histogram.push_back({{"upper_bound_ns", uint64_t{1} << b}, {"count", buckets[b]}});
+            }
+            rpcs[m_rpc_names[i]] = {
+                {"calls", calls},
+                {"mean_ns", calls ? total_ns / calls : 0},
+                {"latency_histogram", std::move(histogram)}
+            };
+        }
+        return json{
+            {"rpcs", std::move(rpcs)},
+            {"bytes_pulled", bytes_pulled},
+            {"bytes_pushed", bytes_pushed},
+            {"in_flight", in_flight}
+        };
+    }
+
+    private:
+
+    struct RPCCounters {
+        std::atomic<uint64_t> calls    = 0;
+        std::atomic<uint64_t> total_ns = 0;
+        std::array<std::atomic<uint64_t>, s_num_buckets> buckets{};
+    };
+
+    struct alignas(64) Slot {
+        std::array<RPCCounters, s_max_rpcs> rpcs;
+        std::atomic<uint64_t> bytes_pulled = 0;
+        std::atomic<uint64_t> bytes_pushed = 0;
+        std::atomic<int64_t>  in_flight    = 0;
+    };
+
+    static size_t bucketOf(int64_t ns) {
+        if(ns <= 0) return 0;
+        return std::min<size_t>(std::bit_width(static_cast<uint64_t>(ns)), s_num_buckets - 1);
+    }
+
+    Slot& slot() {
+        // self_rank() is negative when not called from an execution stream
+        auto rank = tl::xstream::self_rank();
+        return m_slots[static_cast<size_t>(rank < 0 ? 0 : rank) % s_num_slots];
+    }
+
+    std::vector<std::string>        m_rpc_names;
+    std::array<Slot, s_num_slots>   m_slots;
+};
+
+}
+
+#endif
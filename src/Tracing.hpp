@@ -0,0 +1,290 @@
+/*
+ * (C) 2024 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#ifndef __ALPHA_TRACING_H
+#define __ALPHA_TRACING_H
+
+#include <alpha/Exception.hpp>
+
+#include <nlohmann/json.hpp>
+
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace alpha {
+
+/**
+ * @brief The Tracer records timestamped spans (e.g. the lookup, pull,
+ * compute, and push phases of a request) into per-thread ring buffers,
+ * and dumps them in the Chrome trace event format, which can be loaded
+ * in chrome://tracing or https://ui.perfetto.dev.
+ *
+ * Tracing is disabled by default. When enabled, only a fraction of the
+ * requests (the sample rate) is traced: sample() is called when a request
+ * starts and returns either 0 (not traced) or a request id that is then
+ * attached to all the spans of the request. Spans of requests that are
+ * not traced cost nothing beyond a branch.
+ *
+ * Each thread records spans into its own ring buffer, so recording only
+ * contends with dump(). When a ring buffer is full, the oldest spans are
+ * overwritten.
+ */
+class Tracer {
+
+    using json = nlohmann::json;
+
+    struct Event {
+        const char* name;
+        uint64_t    request;
+        uint64_t    start_ns;
+        uint64_t    duration_ns;
+    };
+
+    struct Ring {
+        std::mutex         mutex;
+        std::vector<Event> events;
+        size_t             next  = 0;
+        size_t             count = 0;
+        size_t             tid   = 0;
+    };
+
+    public:
+
+    /**
+     * @brief RAII object recording a span when it is destroyed
+     * (or when end() is called). Span names must be string literals.
+     * The span of a request is declared after the RPC handler's
+     * tl::auto_respond, so that it is recorded before the response is sent.
+     */
+    class Span {
+
+        friend class Tracer;
+
+        Tracer*     m_tracer  = nullptr;
+        const char* m_name    = nullptr;
+        uint64_t    m_request = 0;
+        uint64_t    m_start   = 0;
+
+        Span(Tracer* tracer, const char* name, uint64_t request)
+        : m_tracer(tracer)
+        , m_name(name)
+        , m_request(request)
+        , m_start(now()) {}
+
+        public:
+
+        Span() = default;
+
+        Span(Span&& other)
+        : m_tracer(std::exchange(other.m_tracer, nullptr))
+        , m_name(other.m_name)
+        , m_request(other.m_request)
+        , m_start(other.m_start) {}
+
+        Span& operator=(Span&& other) {
+            if(this == &other) return *this;
+            end();
+            m_tracer  = std::exchange(other.m_tracer, nullptr);
+            m_name    = other.m_name;
+            m_request = other.m_request;
+            m_start   = other.m_start;
+            return *this;
+        }
+
+        Span(const Span&) = delete;
+
+        Span& operator=(const Span&) = delete;
+
+        ~Span() {
+            end();
+        }
+
+        /**
+         * @brief Record the span. Only the first call has an effect.
+         */
+        void end() {
+            if(!m_tracer) return;
+            m_tracer->record(Event{m_name, m_request, m_start, now() - m_start});
+            m_tracer = nullptr;
+        }
+    };
+
+    /**
+     * @brief Constructor.
+     *
+     * @param label Name of the process in the trace (e.g. "alpha-client").
+     * @param config "tracing" section of the configuration, with optional
+     * fields "enabled" (bool, default false), "sample_rate" (fraction of
+     * the requests to trace, default 1.0) and "buffer_size" (number of spans
+     * kept per thread, default 4096).
+     */
+    Tracer(std::string label, const json& config)
+    : m_label(std::move(label)) {
+        if(config.is_null()) return;
+        if(!config.is_object())
+            throw Exception{"\"tracing\" field in Alpha configuration should be an object"};
+        if(config.contains("enabled") && !config["enabled"].is_boolean())
+            throw Exception{"\"enabled\" field in Alpha tracing configuration should be a boolean"};
+        m_enabled = config.value("enabled", false);
+        if(config.contains("sample_rate")) {
+            auto& rate = config["sample_rate"];
+            if(!rate.is_number() || rate.get<double>() < 0.0 || rate.get<double>() > 1.0)
+                throw Exception{"\"sample_rate\" field in Alpha tracing configuration "
+                                "should be a number between 0 and 1"};
+            m_sample_rate = rate.get<double>();
+        }
+        if(config.contains("buffer_size")) {
+            auto& size = config["buffer_size"];
+            if(!size.is_number_unsigned() || size.get<size_t>() == 0)
+                throw Exception{"\"buffer_size\" field in Alpha tracing configuration "
+                                "should be a positive integer"};
+            m_buffer_size = size.get<size_t>();
+        }
+        m_threshold = static_cast<uint64_t>(m_sample_rate * static_cast<double>(s_resolution));
+    }
+
+    Tracer(const Tracer&) = delete;
+
+    Tracer& operator=(const Tracer&) = delete;
+
+    /**
+     * @brief Decide whether a new request should be traced.
+     *
+     * @return 0 if the request should not be traced, a request id otherwise.
+     */
+    uint64_t sample() {
+        if(!m_enabled || m_threshold == 0) return 0;
+        auto request = m_next_request.fetch_add(1, std::memory_order_relaxed);
+        if(m_threshold < s_resolution && mix(request) % s_resolution >= m_threshold)
+            return 0;
+        return request;
+    }
+
+    /**
+     * @brief Start a span for the specified request. If the request
+     * is 0 (not traced) the returned Span does nothing.
+     */
+    Span span(const char* name, uint64_t request) {
+        if(request == 0) return Span{};
+        return Span{this, name, request};
+    }
+
+    /**
+     * @brief Return the tracer's configuration.
+     */
+    json getConfig() const {
+        return json{
+            {"enabled", m_enabled},
+            {"sample_rate", m_sample_rate},
+            {"buffer_size", m_buffer_size}
+        };
+    }
+
+    /**
+     * @brief Return the recorded spans in Chrome's JSON trace format.
+     */
+    std::string dump() const {
+        auto pid = static_cast<int64_t>(getpid());
+        auto events = json::array();
+        events.push_back({
+            {"name", "process_name"}, {"ph", "M"}, {"pid", pid},
+            {"args", {{"name", m_label}}}
+        });
+        std::vector<std::shared_ptr<Ring>> rings;
+        {
+            std::unique_lock<std::mutex> lock{m_rings_mutex};
+            rings = m_rings;
+        }
+        for(auto& ring : rings) {
+            std::unique_lock<std::mutex> lock{ring->mutex};
+            auto first = (ring->next + ring->events.size() - ring->count) % ring->events.size();
+            for(size_t i = 0; i < ring->count; ++i) {
+                auto& event = ring->events[(first + i) % ring->events.size()];
+                events.push_back({
+                    {"name", event.name},
+                    {"cat", m_label},
+                    {"ph", "X"},
+                    {"ts", event.start_ns / 1000.0},
+                    {"dur", event.duration_ns / 1000.0},
+                    {"pid", pid},
+                    {"tid", ring->tid},
+                    {"args", {{"request", event.request}}}
+                });
+            }
+        }
+        return json{{"traceEvents", std::move(events)}, {"displayTimeUnit", "ns"}}.dump();
+    }
+
+    private:
+
+    static constexpr uint64_t s_resolution = 1000000;
+
+    static uint64_t now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    static uint64_t mix(uint64_t x) {
+        // splitmix64 finalizer, so that consecutive ids are sampled uniformly
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+
+    void record(const Event& event) {
+        auto& ring = localRing();
+        std::unique_lock<std::mutex> lock{ring.mutex};
+        ring.events[ring.next] = event;
+        ring.next  = (ring.next + 1) % ring.events.size();
+        ring.count = std::min(ring.count + 1, ring.events.size());
+    }
+
+    Ring& localRing() {
+        // rings are found by tracer id rather than by address, since
+        // a new Tracer may be allocated where a destroyed one used to be
+        thread_local std::vector<std::pair<uint64_t, std::weak_ptr<Ring>>> t_rings;
+        for(auto& [id, weak_ring] : t_rings) {
+            if(id != m_id) continue;
+            if(auto ring = weak_ring.lock()) return *ring;
+        }
+        std::erase_if(t_rings, [](auto& entry) { return entry.second.expired(); });
+        auto ring = std::make_shared<Ring>();
+        ring->events.resize(m_buffer_size);
+        {
+            std::unique_lock<std::mutex> lock{m_rings_mutex};
+            ring->tid = m_rings.size();
+            m_rings.push_back(ring);
+        }
+        t_rings.emplace_back(m_id, ring);
+        return *ring;
+    }
+
+    static uint64_t nextTracerId() {
+        static std::atomic<uint64_t> s_next_id = 1;
+        return s_next_id.fetch_add(1);
+    }
+
+    std::string           m_label;
+    bool                  m_enabled     = false;
+    double                m_sample_rate = 1.0;
+    size_t                m_buffer_size = 4096;
+    uint64_t              m_threshold   = s_resolution;
+    uint64_t              m_id          = nextTracerId();
+    std::atomic<uint64_t> m_next_request = 1;
+    mutable std::mutex    m_rings_mutex;
+    std::vector<std::shared_ptr<Ring>> m_rings;
+};
+
+}
+
+#endif
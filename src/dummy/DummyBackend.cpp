@@ -5,9 +5,329 @@
  */
 #include "DummyBackend.hpp"
 #include <iostream>
+#include <type_traits>
+#include <vector>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define DUMMY_HAS_X86_KERNELS
+#include <immintrin.h>
+#endif
 
 ALPHA_REGISTER_BACKEND(dummy, DummyResource);
 
+namespace {
+
+// TUTORIAL
+// ********
+//
+// The kernels are templated on the element type T. Each instruction set
+// (SSE2, AVX2, AVX-512) has an Ops<T> traits class providing the vector width
+// and a function adding one vector of T, so that the compiler generates one
+// specialized kernel per (instruction set, element type) pair. The kernel for
+// each T is selected once, at the first call, based on the CPU's features.
+
+template<typename T>
+using SumKernel = void (*)(const T*, const T*, T*, size_t);
+
+// Integer additions are done on unsigned integers so that overflows wrap
+// around the same way in the scalar loop and in the SIMD kernels.
+template<typename T>
+void sumKernelScalar(const T* x, const T* y, T* r, size_t n) {
+    if constexpr (std::is_integral_v<T>) {
+        using U = std::make_unsigned_t<T>;
+        for(size_t i = 0; i < n; ++i)
+            r[i] = static_cast<T>(static_cast<U>(x[i]) + static_cast<U>(y[i]));
+    } else {
+        for(size_t i = 0; i < n; ++i)
+            r[i] = x[i] + y[i];
+    }
+}
+
+#ifdef DUMMY_HAS_X86_KERNELS
+
+template<typename T> struct SSE2Ops;
+template<typename T> struct AVX2Ops;
+template<typename T> struct AVX512Ops;
+
+#define DUMMY_DEFINE_OPS(__ops, __target, __type, __width, __load, __store, __add) \
+    template<> struct __ops<__type> {                                             \
+        static constexpr size_t width = __width;                                  \
+        __attribute__((target(__target), always_inline))                          \
+        static inline void add(const __type* x, const __type* y, __type* r) {     \
+            __store(r, __add(__load(x), __load(y)));                              \
+        }                                                                         \
+    }
+
+#define DUMMY_SSE2_LOADI(p)      _mm_loadu_si128(reinterpret_cast<const __m128i*>(p))
+#define DUMMY_SSE2_STOREI(p, v)  _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v)
+#define DUMMY_AVX2_LOADI(p)      _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p))
+#define DUMMY_AVX2_STOREI(p, v)  _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v)
+
+DUMMY_DEFINE_OPS(SSE2Ops,   "sse2",    int32_t, 4,  DUMMY_SSE2_LOADI, DUMMY_SSE2_STOREI, _mm_add_epi32);
+DUMMY_DEFINE_OPS(SSE2Ops,   "sse2",    int64_t, 2,  DUMMY_SSE2_LOADI, DUMMY_SSE2_STOREI, _mm_add_epi64);
+DUMMY_DEFINE_OPS(SSE2Ops,   "sse2",    float,   4,  _mm_loadu_ps,     _mm_storeu_ps,     _mm_add_ps);
+DUMMY_DEFINE_OPS(SSE2Ops,   "sse2",    double,  2,  _mm_loadu_pd,     _mm_storeu_pd,     _mm_add_pd);
+DUMMY_DEFINE_OPS(AVX2Ops,   "avx2",    int32_t, 8,  DUMMY_AVX2_LOADI, DUMMY_AVX2_STOREI, _mm256_add_epi32);
+DUMMY_DEFINE_OPS(AVX2Ops,   "avx2",    int64_t, 4,  DUMMY_AVX2_LOADI, DUMMY_AVX2_STOREI, _mm256_add_epi64);
+DUMMY_DEFINE_OPS(AVX2Ops,   "avx2",    float,   8,  _mm256_loadu_ps,  _mm256_storeu_ps,  _mm256_add_ps);
+DUMMY_DEFINE_OPS(AVX2Ops,   "avx2",    double,  4,  _mm256_loadu_pd,  _mm256_storeu_pd,  _mm256_add_pd);
+DUMMY_DEFINE_OPS(AVX512Ops, "avx512f", int32_t, 16, _mm512_loadu_si512, _mm512_storeu_si512, _mm512_add_epi32);
+DUMMY_DEFINE_OPS(AVX512Ops, "avx512f", int64_t, 8,  _mm512_loadu_si512, _mm512_storeu_si512, _mm512_add_epi64);
+DUMMY_DEFINE_OPS(AVX512Ops, "avx512f", float,   16, _mm512_loadu_ps,    _mm512_storeu_ps,    _mm512_add_ps);
+DUMMY_DEFINE_OPS(AVX512Ops, "avx512f", double,  8,  _mm512_loadu_pd,    _mm512_storeu_pd,    _mm512_add_pd);
+
+#undef DUMMY_SSE2_LOADI
+#undef DUMMY_SSE2_STOREI
+#undef DUMMY_AVX2_LOADI
+#undef DUMMY_AVX2_STOREI
+#undef DUMMY_DEFINE_OPS
+
+template<typename T>
+__attribute__((target("sse2")))
+void sumKernelSSE2(const T* x, const T* y, T* r, size_t n) {
+    size_t i = 0;
+    for(; i + SSE2Ops<T>::width <= n; i += SSE2Ops<T>::width)
+        SSE2Ops<T>::add(x + i, y + i, r + i);
+    sumKernelScalar(x + i, y + i, r + i, n - i);
+}
+
+template<typename T>
+__attribute__((target("avx2")))
+void sumKernelAVX2(const T* x, const T* y, T* r, size_t n) {
+    size_t i = 0;
+    for(; i + AVX2Ops<T>::width <= n; i += AVX2Ops<T>::width)
+        AVX2Ops<T>::add(x + i, y + i, r + i);
+    sumKernelScalar(x + i, y + i, r + i, n - i);
+}
+
+template<typename T>
+__attribute__((target("avx512f")))
+void sumKernelAVX512(const T* x, const T* y, T* r, size_t n) {
+    size_t i = 0;
+    for(; i + AVX512Ops<T>::width <= n; i += AVX512Ops<T>::width)
+        AVX512Ops<T>::add(x + i, y + i, r + i);
+    sumKernelScalar(x + i, y + i, r + i, n - i);
+}
+
+#endif
+
+template<typename T>
+SumKernel<T> selectSumKernel() {
+#ifdef DUMMY_HAS_X86_KERNELS
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx512f")) return sumKernelAVX512<T>;
+    if(__builtin_cpu_supports("avx2"))    return sumKernelAVX2<T>;
+    if(__builtin_cpu_supports("sse2"))    return sumKernelSSE2<T>;
+#endif
+    return sumKernelScalar<T>;
+}
+
+template<typename T>
+alpha::Result<bool> computeSumsWithKernel(std::span<const T> x,
+                                          std::span<const T> y,
+                                          std::span<T> result) {
+    static const SumKernel<T> kernel = selectSumKernel<T>();
+    alpha::Result<bool> r;
+    if(x.size() != y.size() || x.size() != result.size()) {
+        r.success() = false;
+        r.error() = "computeSums arguments must have the same size";
+        return r;
+    }
+    kernel(x.data(), y.data(), result.data(), x.size());
+    return r;
+}
+
+// Reductions use the portable kernel from alpha/Reduction.hpp, which is
+// written so that the compiler can vectorize it. It is always inlined, so
+// compiling it in functions targeting AVX2 or AVX-512 produces kernels using
+// these instruction sets, selected at the first call like the sum kernels.
+
+template<typename T>
+using ReduceKernel = alpha::ReduceAccumulator<T> (*)(alpha::ReduceOp, const T*, const T*, size_t);
+
+template<typename T>
+alpha::ReduceAccumulator<T> reduceKernelDefault(alpha::ReduceOp op, const T* x, const T* y, size_t n) {
+    return alpha::reduceKernel(op, x, y, n);
+}
+
+#ifdef DUMMY_HAS_X86_KERNELS
+
+template<typename T>
+__attribute__((target("avx2")))
+alpha::ReduceAccumulator<T> reduceKernelAVX2(alpha::ReduceOp op, const T* x, const T* y, size_t n) {
+    return alpha::reduceKernel(op, x, y, n);
+}
+
+template<typename T>
+__attribute__((target("avx512f")))
+alpha::ReduceAccumulator<T> reduceKernelAVX512(alpha::ReduceOp op, const T* x, const T* y, size_t n) {
+    return alpha::reduceKernel(op, x, y, n);
+}
+
+#endif
+
+template<typename T>
+ReduceKernel<T> selectReduceKernel() {
+#ifdef DUMMY_HAS_X86_KERNELS
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx512f")) return reduceKernelAVX512<T>;
+    if(__builtin_cpu_supports("avx2"))    return reduceKernelAVX2<T>;
+#endif
+    return reduceKernelDefault<T>;
+}
+
+template<typename T>
+alpha::Result<alpha::ReduceAccumulator<T>> reduceWithKernel(alpha::ReduceOp op,
+                                                            std::span<const T> x,
+                                                            std::span<const T> y) {
+    static const ReduceKernel<T> kernel = selectReduceKernel<T>();
+    alpha::Result<alpha::ReduceAccumulator<T>> r;
+    if(!alpha::checkReduceArguments(op, x.size(), y.size(), r))
+        return r;
+    r.value() = kernel(op, x.data(), y.empty() ? nullptr : y.data(), x.size());
+    return r;
+}
+
+// Scans of integer arrays are vectorized with in-register prefix sums: each
+// vector is added to itself shifted by 1, 2, (4,) ... elements within each
+// 128-bit lane, then the total of the low lane is added to the high lane, and
+// the carry of the previous vectors to all the elements. The last element is
+// the carry of the next vector. Exclusive scans subtract the input from the
+// inclusive scan. Floating-point scans use the sequential kernel, since
+// reordering their additions would change the rounding of the results.
+
+template<typename T>
+using ScanKernel = T (*)(alpha::ScanType, const T*, T*, size_t, T);
+
+template<typename T>
+T scanKernelDefault(alpha::ScanType type, const T* x, T* r, size_t n, T carry) {
+    return alpha::scanKernel(type, x, r, n, carry);
+}
+
+#ifdef DUMMY_HAS_X86_KERNELS
+
+__attribute__((target("avx2")))
+int32_t scanKernelAVX2(alpha::ScanType type, const int32_t* x, int32_t* r, size_t n, int32_t carry) {
+    const bool exclusive = type == alpha::ScanType::Exclusive;
+    const __m256i last = _mm256_set1_epi32(7);
+    __m256i c = _mm256_set1_epi32(carry);
+    size_t i = 0;
+    for(; i + 8 <= n; i += 8) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + i));
+        __m256i s = _mm256_add_epi32(v, _mm256_slli_si256(v, 4));
+        s = _mm256_add_epi32(s, _mm256_slli_si256(s, 8));
+        __m256i low_total = _mm256_shuffle_epi32(s, 0xFF);
+        s = _mm256_add_epi32(s, _mm256_permute2x128_si256(low_total, low_total, 0x08));
+        s = _mm256_add_epi32(s, c);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(r + i), exclusive ? _mm256_sub_epi32(s, v) : s);
+        c = _mm256_permutevar8x32_epi32(s, last);
+    }
+    return alpha::scanKernel(type, x + i, r + i, n - i, _mm256_cvtsi256_si32(c));
+}
+
+__attribute__((target("avx2")))
+int64_t scanKernelAVX2(alpha::ScanType type, const int64_t* x, int64_t* r, size_t n, int64_t carry) {
+    const bool exclusive = type == alpha::ScanType::Exclusive;
+    __m256i c = _mm256_set1_epi64x(carry);
+    size_t i = 0;
+    for(; i + 4 <= n; i += 4) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + i));
+        __m256i s = _mm256_add_epi64(v, _mm256_slli_si256(v, 8));
+        __m256i low_total = _mm256_unpackhi_epi64(s, s);
+        s = _mm256_add_epi64(s, _mm256_permute2x128_si256(low_total, low_total, 0x08));
+        s = _mm256_add_epi64(s, c);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(r + i), exclusive ? _mm256_sub_epi64(s, v) : s);
+        c = _mm256_permute4x64_epi64(s, 0xFF);
+    }
+    return alpha::scanKernel(type, x + i, r + i, n - i,
+                             static_cast<int64_t>(_mm_cvtsi128_si64(_mm256_castsi256_si128(c))));
+}
+
+#endif
+
+template<typename T>
+ScanKernel<T> selectScanKernel() {
+#ifdef DUMMY_HAS_X86_KERNELS
+    if constexpr (std::is_integral_v<T>) {
+        __builtin_cpu_init();
+        if(__builtin_cpu_supports("avx2")) return scanKernelAVX2;
+    }
+#endif
+    return scanKernelDefault<T>;
+}
+
+template<typename T>
+alpha::Result<bool> scanWithKernel(alpha::ScanType type,
+                                   std::span<const T> x,
+                                   std::span<T> result,
+                                   T carry) {
+    static const ScanKernel<T> kernel = selectScanKernel<T>();
+    alpha::Result<bool> r;
+    if(!alpha::checkScanArguments(type, x.size(), result.size(), r))
+        return r;
+    kernel(type, x.data(), result.data(), x.size(), carry);
+    return r;
+}
+
+
+// Expressions use the portable block interpreter from alpha/Expression.hpp,
+// which is always inlined like the reduction kernel, so the loops of each
+// instruction are vectorized for the instruction set the kernel targets.
+
+template<typename T>
+using EvaluateKernel = void (*)(const alpha::Expression&, const T* const*, T*, size_t, T*);
+
+template<typename T>
+void evaluateKernelDefault(const alpha::Expression& expr, const T* const* inputs,
+                           T* result, size_t n, T* registers) {
+    alpha::evaluateKernel(expr, inputs, result, n, registers);
+}
+
+#ifdef DUMMY_HAS_X86_KERNELS
+
+template<typename T>
+__attribute__((target("avx2")))
+void evaluateKernelAVX2(const alpha::Expression& expr, const T* const* inputs,
+                        T* result, size_t n, T* registers) {
+    alpha::evaluateKernel(expr, inputs, result, n, registers);
+}
+
+template<typename T>
+__attribute__((target("avx512f")))
+void evaluateKernelAVX512(const alpha::Expression& expr, const T* const* inputs,
+                          T* result, size_t n, T* registers) {
+    alpha::evaluateKernel(expr, inputs, result, n, registers);
+}
+
+#endif
+
+template<typename T>
+EvaluateKernel<T> selectEvaluateKernel() {
+#ifdef DUMMY_HAS_X86_KERNELS
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx512f")) return evaluateKernelAVX512<T>;
+    if(__builtin_cpu_supports("avx2"))    return evaluateKernelAVX2<T>;
+#endif
+    return evaluateKernelDefault<T>;
+}
+
+template<typename T>
+alpha::Result<bool> evaluateWithKernel(const alpha::Expression& expr,
+                                       std::span<const std::span<const T>> inputs,
+                                       std::span<T> result) {
+    static const EvaluateKernel<T> kernel = selectEvaluateKernel<T>();
+    alpha::Result<bool> r;
+    if(!alpha::checkExpressionArguments(expr, inputs, result, r))
+        return r;
+    const T* input_data[alpha::Expression::s_max_inputs];
+    for(size_t i = 0; i < inputs.size(); ++i) input_data[i] = inputs[i].data();
+    std::vector<T> registers(alpha::Expression::s_num_registers*alpha::Expression::s_block_size);
+    kernel(expr, input_data, result.data(), result.size(), registers.data());
+    return r;
+}
+
+}
+
 DummyResource::DummyResource(thallium::engine engine, const json& config)
 : m_engine(std::move(engine)),
   m_config(config) {
@@ -24,6 +344,106 @@ alpha::Result<int32_t> DummyResource::computeSum(int32_t x, int32_t y) {
     return result;
 }
 
+alpha::Result<bool> DummyResource::computeSums(std::span<const int32_t> x,
+                                               std::span<const int32_t> y,
+                                               std::span<int32_t> result) {
+    return computeSumsWithKernel(x, y, result);
+}
+
+alpha::Result<bool> DummyResource::computeSums(std::span<const int64_t> x,
+                                               std::span<const int64_t> y,
+                                               std::span<int64_t> result) {
+    return computeSumsWithKernel(x, y, result);
+}
+
+alpha::Result<bool> DummyResource::computeSums(std::span<const float> x,
+                                               std::span<const float> y,
+                                               std::span<float> result) {
+    return computeSumsWithKernel(x, y, result);
+}
+
+alpha::Result<bool> DummyResource::computeSums(std::span<const double> x,
+                                               std::span<const double> y,
+                                               std::span<double> result) {
+    return computeSumsWithKernel(x, y, result);
+}
+
+alpha::Result<int64_t> DummyResource::reduce(alpha::ReduceOp op,
+                                             std::span<const int32_t> x,
+                                             std::span<const int32_t> y) {
+    return reduceWithKernel(op, x, y);
+}
+
+alpha::Result<int64_t> DummyResource::reduce(alpha::ReduceOp op,
+                                             std::span<const int64_t> x,
+                                             std::span<const int64_t> y) {
+    return reduceWithKernel(op, x, y);
+}
+
+alpha::Result<double> DummyResource::reduce(alpha::ReduceOp op,
+                                            std::span<const float> x,
+                                            std::span<const float> y) {
+    return reduceWithKernel(op, x, y);
+}
+
+alpha::Result<double> DummyResource::reduce(alpha::ReduceOp op,
+                                            std::span<const double> x,
+                                            std::span<const double> y) {
+    return reduceWithKernel(op, x, y);
+}
+
+alpha::Result<bool> DummyResource::scan(alpha::ScanType type,
+                                         std::span<const int32_t> x,
+                                         std::span<int32_t> result,
+                                         int32_t carry) {
+    return scanWithKernel(type, x, result, carry);
+}
+
+alpha::Result<bool> DummyResource::scan(alpha::ScanType type,
+                                         std::span<const int64_t> x,
+                                         std::span<int64_t> result,
+                                         int64_t carry) {
+    return scanWithKernel(type, x, result, carry);
+}
+
+alpha::Result<bool> DummyResource::scan(alpha::ScanType type,
+                                         std::span<const float> x,
+                                         std::span<float> result,
+                                         float carry) {
+    return scanWithKernel(type, x, result, carry);
+}
+
+alpha::Result<bool> DummyResource::scan(alpha::ScanType type,
+                                         std::span<const double> x,
+                                         std::span<double> result,
+                                         double carry) {
+    return scanWithKernel(type, x, result, carry);
+}
+
+alpha::Result<bool> DummyResource::evaluate(const alpha::Expression& expr,
+                                             std::span<const std::span<const int32_t>> inputs,
+                                             std::span<int32_t> result) {
+    return evaluateWithKernel(expr, inputs, result);
+}
+
+alpha::Result<bool> DummyResource::evaluate(const alpha::Expression& expr,
+                                             std::span<const std::span<const int64_t>> inputs,
+                                             std::span<int64_t> result) {
+    return evaluateWithKernel(expr, inputs, result);
+}
+
+alpha::Result<bool> DummyResource::evaluate(const alpha::Expression& expr,
+                                             std::span<const std::span<const float>> inputs,
+                                             std::span<float> result) {
+    return evaluateWithKernel(expr, inputs, result);
+}
+
+alpha::Result<bool> DummyResource::evaluate(const alpha::Expression& expr,
+                                             std::span<const std::span<const double>> inputs,
+                                             std::span<double> result) {
+    return evaluateWithKernel(expr, inputs, result);
+}
+
 std::unique_ptr<alpha::ResourceInterface> DummyResource::Create(const thallium::engine& engine, const json& config) {
     (void)engine;
     return std::unique_ptr<alpha::ResourceInterface>(new DummyResource(engine, config));
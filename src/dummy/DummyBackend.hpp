@@ -65,6 +65,155 @@ class DummyResource : public alpha::ResourceInterface {
      */
     alpha::Result<int32_t> computeSum(int32_t x, int32_t y) override;
 
+    /**
+     * @brief Compute the element-wise sums of two arrays of integers
+     * using the widest SIMD kernel supported by the CPU, specialized
+     * at compile time for the element type.
+     *
+     * @param x first array
+     * @param y second array
+     * @param result array in which to place the sums
+     *
+     * @return a Result indicating whether the operation succeeded.
+     */
+    alpha::Result<bool> computeSums(std::span<const int32_t> x,
+                                    std::span<const int32_t> y,
+                                    std::span<int32_t> result) override;
+
+    /**
+     * @brief Same as above for arrays of 64-bit integers.
+     */
+    alpha::Result<bool> computeSums(std::span<const int64_t> x,
+                                    std::span<const int64_t> y,
+                                    std::span<int64_t> result) override;
+
+    /**
+     * @brief Same as above for arrays of floats.
+     */
+    alpha::Result<bool> computeSums(std::span<const float> x,
+                                    std::span<const float> y,
+                                    std::span<float> result) override;
+
+    /**
+     * @brief Same as above for arrays of doubles.
+     */
+    alpha::Result<bool> computeSums(std::span<const double> x,
+                                    std::span<const double> y,
+                                    std::span<double> result) override;
+
+    /**
+     * @brief Reduce an array of integers (or the element-wise sums of two
+     * arrays) using the portable reduction kernel compiled for the widest
+     * instruction set supported by the CPU.
+     *
+     * @param op reduction operation
+     * @param x first array
+     * @param y second array (may be empty)
+     *
+     * @return a Result containing the reduced value.
+     */
+    alpha::Result<int64_t> reduce(alpha::ReduceOp op,
+                                  std::span<const int32_t> x,
+                                  std::span<const int32_t> y) override;
+
+    /**
+     * @brief Same as above for arrays of 64-bit integers.
+     */
+    alpha::Result<int64_t> reduce(alpha::ReduceOp op,
+                                  std::span<const int64_t> x,
+                                  std::span<const int64_t> y) override;
+
+    /**
+     * @brief Same as above for arrays of floats.
+     */
+    alpha::Result<double> reduce(alpha::ReduceOp op,
+                                 std::span<const float> x,
+                                 std::span<const float> y) override;
+
+    /**
+     * @brief Same as above for arrays of doubles.
+     */
+    alpha::Result<double> reduce(alpha::ReduceOp op,
+                                 std::span<const double> x,
+                                 std::span<const double> y) override;
+
+    /**
+     * @brief Compute the inclusive or exclusive scan of an array of integers,
+     * starting from the specified carry, using an in-register SIMD prefix sum
+     * if the CPU supports AVX2.
+     *
+     * @param type inclusive or exclusive scan
+     * @param x input array
+     * @param result array in which to place the running totals (may be x)
+     * @param carry value to which the running totals are added
+     *
+     * @return a Result indicating whether the operation succeeded.
+     */
+    alpha::Result<bool> scan(alpha::ScanType type,
+                             std::span<const int32_t> x,
+                             std::span<int32_t> result,
+                             int32_t carry) override;
+
+    /**
+     * @brief Same as above for arrays of 64-bit integers.
+     */
+    alpha::Result<bool> scan(alpha::ScanType type,
+                             std::span<const int64_t> x,
+                             std::span<int64_t> result,
+                             int64_t carry) override;
+
+    /**
+     * @brief Same as above for arrays of floats (scanned sequentially).
+     */
+    alpha::Result<bool> scan(alpha::ScanType type,
+                             std::span<const float> x,
+                             std::span<float> result,
+                             float carry) override;
+
+    /**
+     * @brief Same as above for arrays of doubles (scanned sequentially).
+     */
+    alpha::Result<bool> scan(alpha::ScanType type,
+                             std::span<const double> x,
+                             std::span<double> result,
+                             double carry) override;
+
+    /**
+     * @brief Evaluate an element-wise Expression over arrays of integers
+     * using the block interpreter compiled for the widest instruction set
+     * supported by the CPU.
+     *
+     * @param expr expression to evaluate
+     * @param inputs input arrays
+     * @param result array in which to place the values
+     *
+     * @return a Result indicating whether the operation succeeded.
+     */
+    alpha::Result<bool> evaluate(const alpha::Expression& expr,
+                                 std::span<const std::span<const int32_t>> inputs,
+                                 std::span<int32_t> result) override;
+
+    /**
+     * @brief Same as above for arrays of 64-bit integers.
+     */
+    alpha::Result<bool> evaluate(const alpha::Expression& expr,
+                                 std::span<const std::span<const int64_t>> inputs,
+                                 std::span<int64_t> result) override;
+
+    /**
+     * @brief Same as above for arrays of floats.
+     */
+    alpha::Result<bool> evaluate(const alpha::Expression& expr,
+                                 std::span<const std::span<const float>> inputs,
+                                 std::span<float> result) override;
+
+    /**
+     * @brief Same as above for arrays of doubles.
+     */
+    alpha::Result<bool> evaluate(const alpha::Expression& expr,
+                                 std::span<const std::span<const double>> inputs,
+                                 std::span<double> result) override;
+
     /**
      * @brief Static factory function used by the ResourceFactory to
      * create a DummyResource.
@@ -37,4 +37,12 @@ TEST_CASE("Client test", "[client]") {
         REQUIRE_THROWS_AS(client.makeResourceHandle(addr, 55), alpha::Exception);
         REQUIRE_NOTHROW(client.makeResourceHandle(addr, 55, false));
     }
+
+    SECTION("Client configuration") {
+        REQUIRE_NOTHROW(alpha::Client(engine, R"({"registration_cache": {"capacity": 8}})"));
+        REQUIRE_THROWS_AS(alpha::Client(engine, "[1,2]"), alpha::Exception);
+        REQUIRE_THROWS_AS(alpha::Client(engine, R"({"registration_cache": 8})"), alpha::Exception);
+        REQUIRE_NOTHROW(alpha::Client(engine, R"({"inline_threshold": "auto"})"));
+        REQUIRE_THROWS_AS(alpha::Client(engine, R"({"inline_threshold": "never"})"), alpha::Exception);
+    }
 }
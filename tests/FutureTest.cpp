@@ -0,0 +1,114 @@
+/*
+ * (C) 2024 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_all.hpp>
+#include "Ensure.hpp"
+#include <alpha/Client.hpp>
+#include <alpha/Provider.hpp>
+#include <alpha/Task.hpp>
+
+#if defined(__cpp_impl_coroutine)
+namespace {
+
+alpha::Task sumTwice(alpha::ResourceHandle rh, int32_t& out, thallium::eventual<void>& done) {
+    int32_t v = co_await rh.computeSum(1, 2);
+    out = co_await rh.computeSum(v, v);
+    done.set_value();
+}
+
+}
+#endif
+
+TEST_CASE("Future test", "[future]") {
+    auto engine = thallium::engine("na+sm", THALLIUM_SERVER_MODE);
+    ENSURE(engine.finalize());
+    const auto provider_config = R"(
+    {
+        "resource": {
+            "type": "dummy",
+            "config": {}
+        }
+    }
+    )";
+    alpha::Provider provider(engine, 42, provider_config);
+    alpha::Client client(engine);
+    auto rh = client.makeResourceHandle(engine.self(), 42);
+
+    SECTION("waitAll") {
+        std::vector<alpha::Future<int32_t>> futures;
+        for(int32_t i = 0; i < 10; ++i)
+            futures.push_back(rh.computeSum(i, 1));
+        auto results = alpha::waitAll(futures);
+        REQUIRE(results.size() == 10);
+        for(int32_t i = 0; i < 10; ++i)
+            REQUIRE(results[i] == i + 1);
+    }
+
+    SECTION("waitAll on Future<void>") {
+        std::vector<int32_t> x{1,2,3}, y{4,5,6}, r1(3), r2(3);
+        std::vector<alpha::Future<void>> futures;
+        futures.push_back(rh.computeSums(x, y, r1));
+        futures.push_back(rh.computeSums(y, x, r2));
+        REQUIRE_NOTHROW(alpha::waitAll(futures));
+        REQUIRE(r1 == r2);
+    }
+
+    SECTION("waitAny") {
+        std::vector<alpha::Future<int32_t>> futures;
+        for(int32_t i = 0; i < 10; ++i)
+            futures.push_back(rh.computeSum(i, 1));
+        auto j = alpha::waitAny(futures);
+        REQUIRE(j < futures.size());
+        REQUIRE(futures[j].completed());
+        // all the futures, including the one returned by waitAny, can still be awaited
+        for(int32_t i = 0; i < 10; ++i)
+            REQUIRE(futures[i].wait() == i + 1);
+    }
+
+    SECTION("invalid Future") {
+        alpha::Future<int32_t> invalid;
+        REQUIRE_THROWS_AS(invalid.completed(), alpha::Exception);
+        REQUIRE_THROWS_AS(invalid.wait(), alpha::Exception);
+        auto future = rh.computeSum(1, 2);
+        auto moved  = std::move(future);
+        REQUIRE_THROWS_AS(future.completed(), alpha::Exception);
+        REQUIRE_THROWS_AS(future.wait(), alpha::Exception);
+        REQUIRE(moved.wait() == 3);
+    }
+
+    SECTION("then") {
+        auto pool = engine.get_handler_pool();
+        auto doubled = rh.computeSum(20, 1).then(
+            [](int32_t v) { return 2*v; }, pool);
+        REQUIRE(doubled.wait() == 42);
+
+        auto chained = rh.computeSum(1, 2)
+            .then([rh](int32_t v) { return rh.computeSum(v, v).wait(); }, pool)
+            .then([](int32_t v) { return std::to_string(v); }, pool);
+        REQUIRE(chained.wait() == "6");
+
+        auto failed = rh.computeSum(1, 2).then(
+            [](int32_t) -> int32_t { throw alpha::Exception{"error in continuation"}; }, pool);
+        REQUIRE_THROWS_AS(failed.wait(), alpha::Exception);
+    }
+
+#if defined(__cpp_impl_coroutine)
+    SECTION("co_await") {
+        int32_t result = 0;
+        thallium::eventual<void> done;
+        sumTwice(rh, result, done);
+        done.wait();
+        REQUIRE(result == 6);
+        // many coroutines suspended at the same time
+        std::vector<int32_t> results(16, 0);
+        std::vector<thallium::eventual<void>> dones(16);
+        for(size_t i = 0; i < results.size(); ++i)
+            sumTwice(rh, results[i], dones[i]);
+        for(auto& d : dones) d.wait();
+        REQUIRE(results == std::vector<int32_t>(16, 6));
+    }
+#endif
+}
@@ -8,6 +8,17 @@
 #include "Ensure.hpp"
 #include <alpha/Client.hpp>
 #include <alpha/Provider.hpp>
+#include <alpha/ResourceGroup.hpp>
+#include <nlohmann/json.hpp>
+#include <set>
+
+// values in [-50, 50], neither sorted nor all positive
+static std::vector<int32_t> makeValues(size_t n) {
+    std::vector<int32_t> values(n);
+    for(size_t i = 0; i < n; ++i)
+        values[i] = static_cast<int32_t>((i*37) % 101) - 50;
+    return values;
+}
 
 TEST_CASE("Resource test", "[resource]") {
     auto engine = thallium::engine("na+sm", THALLIUM_SERVER_MODE);
@@ -34,6 +45,17 @@ TEST_CASE("Resource test", "[resource]") {
             REQUIRE(result == 93);
         }
 
+        SECTION("Send batched Sum RPCs") {
+            rh.enableBatching(8, std::chrono::microseconds{1000});
+            std::vector<alpha::Future<int32_t>> futures;
+            for(int32_t i = 0; i < 20; ++i)
+                futures.push_back(rh.computeSum(i, 2*i));
+            for(int32_t i = 0; i < 20; ++i)
+                REQUIRE(futures[i].wait() == 3*i);
+            rh.disableBatching();
+            REQUIRE(rh.computeSum(1, 2).wait() == 3);
+        }
+
         SECTION("Send Sum RPC with timeout") {
             int32_t result;
             REQUIRE_NOTHROW([&]() {
@@ -53,5 +75,565 @@ TEST_CASE("Resource test", "[resource]") {
             REQUIRE(r[1] == 7);
             REQUIRE(r[2] == 9);
         }
+
+        SECTION("Send Sum RPC for typed spans") {
+            std::vector<int64_t> x64{1ll << 40, -2, 3}, y64{4, 5, 6}, r64(3);
+            REQUIRE_NOTHROW(rh.computeSums(x64, y64, r64).wait());
+            REQUIRE(r64 == std::vector<int64_t>{(1ll << 40) + 4, 3, 9});
+            std::vector<float> xf{0.5f, 1.5f}, yf{0.25f, 2.0f}, rf(2);
+            REQUIRE_NOTHROW(rh.computeSums(xf, yf, rf).wait());
+            REQUIRE(rf == std::vector<float>{0.75f, 3.5f});
+            std::vector<double> xd(1000), yd(1000), rd(1000);
+            for(size_t i = 0; i < xd.size(); ++i) { xd[i] = i*0.5; yd[i] = 1.0; }
+            REQUIRE_NOTHROW(rh.computeSums(xd, yd, rd).wait());
+            for(size_t i = 0; i < rd.size(); ++i) REQUIRE(rd[i] == i*0.5 + 1.0);
+        }
+
+        SECTION("Send Sum RPC for registered buffers") {
+            std::vector<int32_t> x{1,2,3};
+            std::vector<int32_t> y{4,5,6};
+            std::vector<int32_t> r(3);
+
+            auto x_buf = client.registerBuffer(x.data(), x.size()*sizeof(int32_t),
+                                               thallium::bulk_mode::read_only);
+            auto y_buf = client.registerBuffer(y.data(), y.size()*sizeof(int32_t),
+                                               thallium::bulk_mode::read_only);
+            auto r_buf = client.registerBuffer(r.data(), r.size()*sizeof(int32_t),
+                                               thallium::bulk_mode::write_only);
+
+            for(int i = 0; i < 3; ++i) {
+                x[0] = i;
+                REQUIRE_NOTHROW(rh.computeSums(x_buf, y_buf, r_buf).wait());
+                REQUIRE(r[0] == 4 + i);
+                REQUIRE(r[2] == 9);
+            }
+        }
+
+        SECTION("Send Sum RPC for large spans") {
+            // odd size to exercise both the SIMD loop and its scalar tail
+            const size_t n = 1001;
+            std::vector<int32_t> x(n), y(n), r(n);
+            for(size_t i = 0; i < n; ++i) {
+                x[i] = static_cast<int32_t>(i);
+                y[i] = static_cast<int32_t>(2*i + 1);
+            }
+
+            REQUIRE_NOTHROW(rh.computeSums(x, y, r).wait());
+
+            for(size_t i = 0; i < n; ++i) {
+                REQUIRE(r[i] == x[i] + y[i]);
+            }
+        }
+    }
+}
+
+TEST_CASE("Pipelined bulk test", "[resource]") {
+    auto engine = thallium::engine("na+sm", THALLIUM_SERVER_MODE);
+    ENSURE(engine.finalize());
+    const auto provider_config = R"(
+    {
+        "resource": {
+            "type": "dummy",
+            "config": {}
+        },
+        "bulk": {
+            "chunk_size": 64,
+            "pipeline_depth": 3
+        }
+    }
+    )";
+    alpha::Provider provider(engine, 42, provider_config);
+    // force the RDMA path regardless of the array sizes
+    alpha::Client client(engine, R"({"inline_threshold": 0})");
+    auto rh = client.makeResourceHandle(engine.self(), 42);
+
+    SECTION("Send Sum RPC for spans spanning many chunks") {
+        const size_t n = 1001;
+        std::vector<int32_t> x(n), y(n), r(n);
+        for(size_t i = 0; i < n; ++i) {
+            x[i] = static_cast<int32_t>(i);
+            y[i] = static_cast<int32_t>(3*i);
+        }
+
+        REQUIRE_NOTHROW(rh.computeSums(x, y, r).wait());
+
+        for(size_t i = 0; i < n; ++i) {
+            REQUIRE(r[i] == x[i] + y[i]);
+        }
+    }
+
+    SECTION("Buffer pool reuses registered buffers") {
+        std::vector<int32_t> x(100, 1), y(100, 2), r(100);
+        REQUIRE_NOTHROW(rh.computeSums(x, y, r).wait());
+        REQUIRE_NOTHROW(rh.computeSums(x, y, r).wait());
+
+        auto stats = nlohmann::json::parse(provider.getStats());
+        REQUIRE(stats["buffer_pool"]["misses"].get<size_t>() > 0);
+        REQUIRE(stats["buffer_pool"]["hits"].get<size_t>() > 0);
+        REQUIRE(stats["endpoint_cache"]["misses"].get<size_t>() == 1);
+        REQUIRE(stats["endpoint_cache"]["hits"].get<size_t>() == 1);
+    }
+
+    SECTION("Performance counters") {
+        std::vector<int32_t> x(100, 1), y(100, 2), r(100);
+        REQUIRE_NOTHROW(rh.computeSums(x, y, r).wait());
+        REQUIRE(rh.computeSum(1, 2).wait() == 3);
+
+        auto stats = nlohmann::json::parse(rh.getStats().wait());
+        auto& rpcs = stats["rpcs"];
+        REQUIRE(rpcs["alpha_compute_sum"]["calls"].get<size_t>() == 1);
+        REQUIRE(rpcs["alpha_compute_sum_bulk"]["calls"].get<size_t>() == 1);
+        REQUIRE(rpcs["alpha_compute_sum_bulk"]["latency_histogram"].size() == 1);
+        REQUIRE(stats["bytes_pulled"].get<size_t>() == 2*100*sizeof(int32_t));
+        REQUIRE(stats["bytes_pushed"].get<size_t>() == 100*sizeof(int32_t));
+        // the get_stats request itself is in flight, the others were
+        // recorded before their response was sent
+        REQUIRE(stats["in_flight"].get<int64_t>() == 1);
+
+        stats = nlohmann::json::parse(provider.getStats());
+        REQUIRE(stats["rpcs"]["alpha_get_stats"]["calls"].get<size_t>() == 1);
+        REQUIRE(stats["in_flight"].get<int64_t>() == 0);
+    }
+
+    SECTION("Client with registration cache") {
+        alpha::Client caching_client(engine, R"({"registration_cache": {"capacity": 4}, "inline_threshold": 0})");
+        auto config = nlohmann::json::parse(caching_client.getConfig());
+        REQUIRE(config["registration_cache"]["capacity"].get<size_t>() == 4);
+
+        auto crh = caching_client.makeResourceHandle(engine.self(), 42);
+        std::vector<int32_t> x(100, 1), y(100, 2), r(100);
+        for(int i = 0; i < 3; ++i) {
+            x[0] = i;
+            REQUIRE_NOTHROW(crh.computeSums(x, y, r).wait());
+            REQUIRE(r[0] == 2 + i);
+            REQUIRE(r[99] == 3);
+        }
+        caching_client.clearRegistrationCache();
+    }
+
+    SECTION("Inline and RDMA paths") {
+        alpha::Client rdma_client(engine, R"({"inline_threshold": 0})");
+        alpha::Client inline_client(engine, R"({"inline_threshold": 1048576})");
+        const size_t n = 1001;
+        std::vector<int32_t> x(n), y(n), r1(n), r2(n);
+        for(size_t i = 0; i < n; ++i) {
+            x[i] = static_cast<int32_t>(i);
+            y[i] = static_cast<int32_t>(7*i);
+        }
+        REQUIRE_NOTHROW(rdma_client.makeResourceHandle(engine.self(), 42).computeSums(x, y, r1).wait());
+        REQUIRE_NOTHROW(inline_client.makeResourceHandle(engine.self(), 42).computeSums(x, y, r2).wait());
+        REQUIRE(r1 == r2);
+        REQUIRE(r1[n-1] == 8*static_cast<int32_t>(n-1));
+    }
+
+    SECTION("Provider splitting requests across ULTs") {
+        const auto parallel_config = R"(
+        {
+            "resource": { "type": "dummy" },
+            "bulk": { "chunk_size": 256, "pipeline_depth": 3 },
+            "compute": { "grain_size": 16, "max_tasks": 4, "pool": "__primary__" }
+        }
+        )";
+        alpha::Provider parallel_provider(engine, 43, parallel_config);
+        auto prh = client.makeResourceHandle(engine.self(), 43);
+        const size_t n = 1001;
+
+        SECTION("Computation split across ULTs") {
+            auto x = makeValues(n);
+            std::vector<int32_t> y(n), r(n);
+            for(size_t i = 0; i < n; ++i)
+                y[i] = -2*x[i];
+            REQUIRE_NOTHROW(prh.computeSums(x, y, r).wait());
+            for(size_t i = 0; i < n; ++i) {
+                REQUIRE(r[i] == -x[i]);
+            }
+            const auto bad_pool_config = R"(
+            {
+                "resource": { "type": "dummy" },
+                "compute": { "pool": "this-pool-does-not-exist" }
+            }
+            )";
+            REQUIRE_THROWS_AS(alpha::Provider(engine, 44, bad_pool_config), alpha::Exception);
+        }
+
+        SECTION("Reductions") {
+            auto x = makeValues(n);
+            std::vector<int32_t> y(n);
+            for(size_t i = 0; i < n; ++i)
+                y[i] = static_cast<int32_t>(i);
+            for(auto& handle : {rh, prh}) {
+                REQUIRE(handle.reduce(alpha::ReduceOp::Sum, x).wait() == -6);
+                REQUIRE(handle.reduce(alpha::ReduceOp::Min, x).wait() == -50);
+                REQUIRE(handle.reduce(alpha::ReduceOp::Max, x).wait() == 50);
+                REQUIRE(handle.reduce(alpha::ReduceOp::Sum, x, y).wait() == -6 + 500500);
+                REQUIRE(handle.reduce(alpha::ReduceOp::Max, x, y).wait() == 1047);
+            }
+            // int32 sums are accumulated in 64-bit integers
+            std::vector<int32_t> big(n, INT32_MAX);
+            REQUIRE(prh.reduce(alpha::ReduceOp::Sum, big).wait() == int64_t{INT32_MAX}*n);
+            std::vector<double> xd(n), yd(n, 0.25);
+            for(size_t i = 0; i < n; ++i) xd[i] = i*0.5;
+            REQUIRE(prh.reduce(alpha::ReduceOp::Sum, xd).wait() == 250250.0);
+            REQUIRE(prh.reduce(alpha::ReduceOp::Min, xd, yd).wait() == 0.25);
+            std::vector<float> xf{1.5f, -2.5f, 4.0f};
+            REQUIRE(rh.reduce(alpha::ReduceOp::Max, xf).wait() == 4.0);
+            std::vector<int64_t> x64{1ll << 40, -3};
+            REQUIRE(rh.reduce(alpha::ReduceOp::Min, x64).wait() == -3);
+            std::vector<int32_t> empty;
+            REQUIRE(rh.reduce(alpha::ReduceOp::Sum, empty).wait() == 0);
+            REQUIRE_THROWS_AS(rh.reduce(alpha::ReduceOp::Min, empty), alpha::Exception);
+            std::vector<int32_t> other(3);
+            REQUIRE_THROWS_AS(rh.reduce(alpha::ReduceOp::Sum, x, other), alpha::Exception);
+        }
+
+        SECTION("Scans") {
+            auto x = makeValues(n);
+            std::vector<int32_t> inclusive(n), exclusive(n), r(n);
+            int32_t total = 0;
+            for(size_t i = 0; i < n; ++i) {
+                exclusive[i] = total;
+                total += x[i];
+                inclusive[i] = total;
+            }
+            for(auto& handle : {rh, prh}) {
+                REQUIRE_NOTHROW(handle.scan(alpha::ScanType::Inclusive, x, r).wait());
+                REQUIRE(r == inclusive);
+                REQUIRE_NOTHROW(handle.scan(alpha::ScanType::Exclusive, x, r).wait());
+                REQUIRE(r == exclusive);
+            }
+            // integer scans wrap around like computeSums
+            std::vector<int64_t> x64(n, INT64_MAX), r64(n);
+            REQUIRE_NOTHROW(prh.scan(alpha::ScanType::Inclusive, x64, r64).wait());
+            for(size_t i = 0; i < n; ++i)
+                REQUIRE(r64[i] == static_cast<int64_t>(static_cast<uint64_t>(INT64_MAX)*(i+1)));
+            std::vector<double> xd(n, 0.5), rd(n);
+            REQUIRE_NOTHROW(prh.scan(alpha::ScanType::Exclusive, xd, rd).wait());
+            for(size_t i = 0; i < n; ++i) REQUIRE(rd[i] == i*0.5);
+            std::vector<int32_t> other(3);
+            REQUIRE_THROWS_AS(rh.scan(alpha::ScanType::Inclusive, x, other), alpha::Exception);
+        }
+
+        SECTION("Expressions") {
+            auto x = alpha::Expression::input(0);
+            auto y = alpha::Expression::input(1);
+            auto z = alpha::Expression::input(2);
+            auto a = makeValues(n);
+            std::vector<int32_t> b(n), c(n), r(n), expected(n);
+            for(size_t i = 0; i < n; ++i) {
+                b[i] = static_cast<int32_t>(i % 7);
+                c[i] = static_cast<int32_t>(i);
+                expected[i] = 2*a[i] + b[i] - c[i];
+            }
+            for(auto& handle : {rh, prh}) {
+                REQUIRE_NOTHROW(handle.evaluate(2*x + y - z, {a, b, c}, r).wait());
+                REQUIRE(r == expected);
+            }
+            std::vector<double> ad(n), bd(n, 4.0), rd(n);
+            for(size_t i = 0; i < n; ++i) ad[i] = i*0.5;
+            REQUIRE_NOTHROW(prh.evaluate(alpha::Expression::max(-x, y) / 2, {ad, bd}, rd).wait());
+            for(size_t i = 0; i < n; ++i) REQUIRE(rd[i] == std::max(-ad[i], 4.0) / 2);
+            // invalid expressions are reported before sending anything
+            REQUIRE_THROWS_AS(rh.evaluate(x / y, {a, b}, r), alpha::Exception);
+            REQUIRE_THROWS_AS(rh.evaluate(z, {a, b}, r), alpha::Exception);
+            REQUIRE_THROWS_AS(rh.evaluate(alpha::Expression{}, {a}, r), alpha::Exception);
+            std::vector<int32_t> other(3);
+            REQUIRE_THROWS_AS(rh.evaluate(x + y, {a, b}, other), alpha::Exception);
+        }
+    }
+
+    SECTION("Stored arrays") {
+        const auto arrays_config = R"(
+        {
+            "resource": { "type": "dummy" },
+            "bulk": { "chunk_size": 256, "pipeline_depth": 3 },
+            "arrays": { "max_bytes": 1000000, "max_arrays": 2 }
+        }
+        )";
+        alpha::Provider arrays_provider(engine, 43, arrays_config);
+        auto arh = client.makeResourceHandle(engine.self(), 43);
+        const size_t n = 1001;
+        std::vector<int32_t> x(n), y(n), r(n);
+        for(size_t i = 0; i < n; ++i) {
+            x[i] = static_cast<int32_t>(i);
+            y[i] = static_cast<int32_t>(2*i);
+        }
+        alpha::ArrayRef y_ref;
+        REQUIRE_NOTHROW([&]() { y_ref = arh.putArray("y", y).wait(); }());
+        REQUIRE(y_ref.name == "y");
+        REQUIRE(y_ref.size == n*sizeof(int32_t));
+        for(int i = 0; i < 3; ++i) {
+            x[0] = i;
+            REQUIRE_NOTHROW(arh.computeSums(x, y_ref, r).wait());
+            REQUIRE(r[0] == i);
+            REQUIRE(r[n-1] == 3*static_cast<int32_t>(n-1));
+        }
+        // only x is pulled by computeSums with a stored array
+        auto stats = nlohmann::json::parse(arh.getStats().wait());
+        REQUIRE(stats["bytes_pulled"].get<size_t>() == 4*n*sizeof(int32_t));
+        REQUIRE(stats["arrays"]["arrays"].get<size_t>() == 1);
+
+        // a new version replaces the array, references to the old one fail
+        std::fill(y.begin(), y.end(), 1);
+        auto y_ref2 = arh.putArray("y", y).wait();
+        REQUIRE(y_ref2.version > y_ref.version);
+        REQUIRE_THROWS_AS(arh.computeSums(x, y_ref, r).wait(), alpha::Exception);
+        auto latest = y_ref;
+        latest.version = 0;
+        REQUIRE_NOTHROW(arh.computeSums(x, latest, r).wait());
+        REQUIRE(r[n-1] == static_cast<int32_t>(n));
+
+        // the least recently used array is evicted beyond "max_arrays"
+        std::vector<double> d(10, 0.5), rd(10);
+        auto a_ref = arh.putArray("a", d).wait();
+        auto b_ref = arh.putArray("b", d).wait();
+        REQUIRE_THROWS_AS(arh.computeSums(x, y_ref2, r).wait(), alpha::Exception);
+        REQUIRE_NOTHROW(arh.computeSums(d, a_ref, rd).wait());
+        REQUIRE(rd[9] == 1.0);
+        stats = nlohmann::json::parse(arh.getStats().wait());
+        REQUIRE(stats["arrays"]["evictions"].get<size_t>() == 1);
+
+        // type and size are checked before sending anything
+        REQUIRE_THROWS_AS(arh.computeSums(x, a_ref, r), alpha::Exception);
+        std::vector<double> other(3);
+        REQUIRE_THROWS_AS(arh.computeSums(other, b_ref, other), alpha::Exception);
+
+        REQUIRE_NOTHROW(arh.dropArray("b").wait());
+        REQUIRE_THROWS_AS(arh.dropArray("b").wait(), alpha::Exception);
+        REQUIRE_THROWS_AS(arh.computeSums(d, b_ref, rd).wait(), alpha::Exception);
+        REQUIRE_THROWS_AS(arh.putArray("too_large", std::vector<int32_t>(1000000)).wait(), alpha::Exception);
+
+        // the arrays of a destroyed resource are dropped with it
+        auto created = client.createResource(engine.self(), 43, "dummy");
+        REQUIRE_NOTHROW(created.putArray("c", d).wait());
+        REQUIRE_NOTHROW(created.destroy().wait());
+        REQUIRE_THROWS_AS(created.putArray("c", d).wait(), alpha::Exception);
+        stats = nlohmann::json::parse(arh.getStats().wait());
+        REQUIRE(stats["arrays"]["arrays"].get<size_t>() == 1);
+    }
+
+    SECTION("Tracing") {
+        const auto tracing_config = R"(
+        {
+            "resource": { "type": "dummy" },
+            "bulk": { "chunk_size": 64 },
+            "tracing": { "enabled": true, "sample_rate": 1.0, "buffer_size": 1024 }
+        }
+        )";
+        alpha::Provider tracing_provider(engine, 43, tracing_config);
+        alpha::Client tracing_client(engine, R"({"tracing": {"enabled": true}, "inline_threshold": 0})");
+        auto trh = tracing_client.makeResourceHandle(engine.self(), 43);
+        std::vector<int32_t> x(100, 1), y(100, 2), r(100);
+        REQUIRE_NOTHROW(trh.computeSums(x, y, r).wait());
+
+        auto span_names = [](const std::string& trace) {
+            std::set<std::string> names;
+            for(auto& event : nlohmann::json::parse(trace)["traceEvents"])
+                if(event["ph"] == "X") names.insert(event["name"].get<std::string>());
+            return names;
+        };
+        // the request span is recorded before the response is sent
+        auto server_spans = span_names(tracing_provider.dumpTrace());
+        for(auto name : {"computeSumBulk", "lookup", "borrow", "pull", "compute", "push"})
+            REQUIRE(server_spans.count(name) == 1);
+        auto client_spans = span_names(tracing_client.dumpTrace());
+        REQUIRE(client_spans.count("expose") == 1);
+        REQUIRE(client_spans.count("computeSumBulk") == 1);
+        // tracing is disabled by default
+        REQUIRE(span_names(provider.dumpTrace()).empty());
+
+        const auto bad_config = R"(
+        {
+            "resource": { "type": "dummy" },
+            "tracing": { "enabled": true, "sample_rate": 2.0 }
+        }
+        )";
+        REQUIRE_THROWS_AS(alpha::Provider(engine, 44, bad_config), alpha::Exception);
+    }
+
+    SECTION("Per-RPC pools") {
+        const auto pools_config = R"(
+        {
+            "resource": { "type": "dummy" },
+            "rpc_pools": {
+                "alpha_compute_sum": "latency",
+                "alpha_compute_sum_bulk": "__primary__"
+            }
+        }
+        )";
+        std::unordered_map<std::string, thallium::pool> named_pools{
+            {"latency", engine.get_handler_pool()}
+        };
+        alpha::Provider pools_provider(engine, 43, pools_config, thallium::pool{}, named_pools);
+        auto config = nlohmann::json::parse(pools_provider.getConfig());
+        REQUIRE(config["rpc_pools"]["alpha_compute_sum"] == "latency");
+        REQUIRE(config["rpc_pools"]["alpha_compute_sum_bulk"] == "__primary__");
+        auto prh = client.makeResourceHandle(engine.self(), 43);
+        REQUIRE(prh.computeSum(3, 4).wait() == 7);
+        std::vector<int32_t> x{1,2,3}, y{4,5,6}, r(3);
+        REQUIRE_NOTHROW(prh.computeSums(x, y, r).wait());
+        REQUIRE(r == std::vector<int32_t>{5,7,9});
+        const auto unknown_rpc_config = R"(
+        {
+            "resource": { "type": "dummy" },
+            "rpc_pools": { "alpha_does_not_exist": "__primary__" }
+        }
+        )";
+        REQUIRE_THROWS_AS(alpha::Provider(engine, 44, unknown_rpc_config), alpha::Exception);
+        const auto unknown_pool_config = R"(
+        {
+            "resource": { "type": "dummy" },
+            "rpc_pools": { "alpha_compute_sum": "this-pool-does-not-exist" }
+        }
+        )";
+        REQUIRE_THROWS_AS(alpha::Provider(engine, 44, unknown_pool_config), alpha::Exception);
+    }
+
+    SECTION("Invalid bulk configuration") {
+        const auto bad_config = R"(
+        {
+            "resource": { "type": "dummy" },
+            "bulk": { "pipeline_depth": 0 }
+        }
+        )";
+        REQUIRE_THROWS_AS(alpha::Provider(engine, 43, bad_config), alpha::Exception);
+    }
+
+    SECTION("Admission control") {
+        for(auto policy : {"queue", "reject"}) {
+            auto admission_config = nlohmann::json::parse(R"(
+            {
+                "resource": { "type": "dummy" },
+                "bulk": { "chunk_size": 4096, "pipeline_depth": 2 },
+                "admission": { "max_inflight_bytes": 32768 }
+            }
+            )");
+            admission_config["admission"]["policy"] = policy;
+            alpha::Provider admission_provider(engine, 43, admission_config.dump());
+            alpha::Client retry_client(engine, R"({"retry": {"max_attempts": 1000, "initial_backoff_us": 100}})");
+            auto arh = retry_client.makeResourceHandle(engine.self(), 43);
+            const size_t n = 1024*1024;
+            std::vector<std::vector<int32_t>> x(8), y(8), r(8);
+            std::vector<alpha::Future<void>> futures;
+            for(size_t i = 0; i < 8; ++i) {
+                x[i].assign(n, i);
+                y[i].assign(n, 1);
+                r[i].assign(n, 0);
+                futures.push_back(arh.computeSums(x[i], y[i], r[i]));
+            }
+            // a rejected attempt must not make the Future complete, so the
+            // result is already there as soon as waitAny returns its index
+            std::vector<size_t> pending = {0, 1, 2, 3, 4, 5, 6, 7};
+            while(!futures.empty()) {
+                size_t k = alpha::waitAny(futures);
+                REQUIRE(r[pending[k]] == std::vector<int32_t>(n, pending[k]+1));
+                REQUIRE_NOTHROW(futures[k].wait());
+                futures.erase(futures.begin() + k);
+                pending.erase(pending.begin() + k);
+            }
+            auto stats = nlohmann::json::parse(arh.getStats().wait());
+            REQUIRE(stats["admission"]["inflight_bytes"] == 0);
+            REQUIRE(stats["admission"]["admitted"] == 8);
+        }
+        const auto bad_config = R"(
+        {
+            "resource": { "type": "dummy" },
+            "admission": { "policy": "drop" }
+        }
+        )";
+        REQUIRE_THROWS_AS(alpha::Provider(engine, 44, bad_config), alpha::Exception);
+    }
+
+    SECTION("Resource group") {
+        alpha::Provider provider2(engine, 43, provider_config);
+        alpha::Client client(engine);
+        alpha::ResourceGroup group{
+            {client.makeResourceHandle(engine.self(), 42),
+             client.makeResourceHandle(engine.self(), 43)},
+            {1.0, 3.0}};
+        auto slices = group.slices(10);
+        REQUIRE(slices.size() == 2);
+        REQUIRE(slices[0].first == 0);
+        REQUIRE(slices[0].second + slices[1].second == 10);
+        REQUIRE(slices[1].first == slices[0].second);
+        REQUIRE(slices[1].second > slices[0].second);
+        for(size_t n : {1, 3, 1000}) {
+            std::vector<int32_t> x(n), y(n), r(n, 0);
+            for(size_t i = 0; i < n; ++i) { x[i] = i; y[i] = 2*i; }
+            REQUIRE_NOTHROW(group.computeSums(x, y, r).wait());
+            for(size_t i = 0; i < n; ++i) REQUIRE(r[i] == 3*(int32_t)i);
+        }
+        REQUIRE_THROWS_AS(alpha::ResourceGroup(
+            {client.makeResourceHandle(engine.self(), 42)}, {1.0, 2.0}), alpha::Exception);
+        REQUIRE_THROWS_AS(alpha::ResourceGroup(
+            {client.makeResourceHandle(engine.self(), 42)}, {0.0}), alpha::Exception);
+    }
+
+    SECTION("Multiple resources") {
+        const auto multi_config = R"(
+        {
+            "resource": { "type": "dummy" },
+            "resources": [
+                { "id": 7, "type": "dummy" },
+                { "type": "dummy" }
+            ]
+        }
+        )";
+        alpha::Provider multi_provider(engine, 43, multi_config);
+        auto config = nlohmann::json::parse(multi_provider.getConfig());
+        REQUIRE(config["resources"].size() == 3);
+        REQUIRE(config["resources"][0]["id"] == 0);
+        REQUIRE(config["resources"][1]["id"] == 1);
+        REQUIRE(config["resources"][2]["id"] == 7);
+        alpha::Client client(engine);
+        auto rh7 = client.makeResourceHandle(engine.self(), 43, alpha::ResourceID{7});
+        REQUIRE(rh7.resourceID() == alpha::ResourceID{7});
+        REQUIRE(rh7.computeSum(3, 4).wait() == 7);
+        REQUIRE_THROWS_AS(client.makeResourceHandle(engine.self(), 43, alpha::ResourceID{9}),
+                          alpha::Exception);
+        auto created = client.createResource(engine.self(), 43, "dummy");
+        REQUIRE(created.resourceID() == alpha::ResourceID{2});
+        std::vector<int32_t> x{1,2,3}, y{4,5,6}, r(3);
+        REQUIRE_NOTHROW(created.computeSums(x, y, r).wait());
+        REQUIRE(r == std::vector<int32_t>{5,7,9});
+        REQUIRE_NOTHROW(created.destroy().wait());
+        REQUIRE_THROWS_AS(created.computeSum(1, 2).wait(), alpha::Exception);
+        REQUIRE_THROWS_AS(created.destroy().wait(), alpha::Exception);
+        REQUIRE_THROWS_AS(client.createResource(engine.self(), 43, "unknown"), alpha::Exception);
+        const auto duplicate_config = R"(
+        {
+            "resource": { "type": "dummy" },
+            "resources": [ { "id": 0, "type": "dummy" } ]
+        }
+        )";
+        REQUIRE_THROWS_AS(alpha::Provider(engine, 44, duplicate_config), alpha::Exception);
+    }
+}
+
+TEST_CASE("Coalescing test", "[resource]") {
+    auto engine = thallium::engine("na+sm", THALLIUM_SERVER_MODE);
+    ENSURE(engine.finalize());
+    const auto provider_config = R"(
+    {
+        "resource": {
+            "type": "dummy",
+            "config": {}
+        },
+        "coalescing": {
+            "enabled": true,
+            "window_us": 200,
+            "max_batch": 16
+        }
+    }
+    )";
+    alpha::Provider provider(engine, 42, provider_config);
+    alpha::Client client(engine);
+    auto rh = client.makeResourceHandle(engine.self(), 42);
+
+    SECTION("Send concurrent Sum RPCs") {
+        std::vector<alpha::Future<int32_t>> futures;
+        for(int32_t i = 0; i < 50; ++i)
+            futures.push_back(rh.computeSum(i, i+1));
+        for(int32_t i = 0; i < 50; ++i)
+            REQUIRE(futures[i].wait() == 2*i+1);
     }
 }